@@ -1,18 +1,27 @@
 #include "app.h"
 #include <iostream>
+#include <algorithm>
 #include "init/sdl.h"
 #include "init/wgpu.h"
 #include "init/utils.h"
 #include "init/shader.h"
 #include "init/buffer.h"
+#include "init/gpu_memory.h"
 #include "init/pipeline.h"
 #include "init/texture.h"
 #include "shader.wgsl.h"
 
-#include "atlas_bytes.hpp"
 
 namespace flint
 {
+    namespace
+    {
+        double milliseconds_since(uint64_t counter)
+        {
+            return static_cast<double>(SDL_GetPerformanceCounter() - counter) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+        }
+    }
+
     App::App()
         : m_player(
               // Initial position: center of the chunk, 5 blocks above the surface
@@ -24,11 +33,23 @@ namespace flint
               0.1f)
     {
         std::cout << "Initializing app..." << std::endl;
+        m_startupCounter = SDL_GetPerformanceCounter();
         m_windowWidth = 1280;
         m_windowHeight = 720;
         m_window = init::sdl(m_windowWidth, m_windowHeight);
         SDL_SetWindowRelativeMouseMode(m_window, true);
 
+        // World generation and sky lighting only need the CPU, so they run on a
+        // worker while the adapter and device are requested.
+        m_worldRenderer.begin_world_generation(m_player.get_camera_position());
+
+        // Compiled shaders and pipelines are kept between launches in the user's pref directory.
+        if (char *prefPath = SDL_GetPrefPath("flint", "flint-and-timber"))
+        {
+            m_pipelineCache = std::make_unique<init::PipelineCache>(std::filesystem::path(prefPath) / "pipeline_cache");
+            SDL_free(prefPath);
+        }
+
         init::wgpu(
             m_windowWidth,
             m_windowHeight,
@@ -38,15 +59,28 @@ namespace flint
             m_surfaceFormat,
             m_adapter,
             m_device,
-            m_queue //
+            m_queue,
+            m_pipelineCache.get() //
         );
 
-        m_worldRenderer.init(m_device, m_queue, m_surfaceFormat, m_depthTextureFormat);
+        m_framePacer.init(init::surface_present_modes(m_surface, m_adapter));
+
+        m_frameUniforms.init(m_device);
+        m_uploadScheduler.init(m_device);
+
+        m_gpuProfiler.init(m_device);
+        m_worldPassTimer = m_gpuProfiler.add_pass("World");
+        m_overlayPassTimer = m_gpuProfiler.add_pass("Overlay");
+
+        m_worldRenderer.init(m_device, m_queue, m_surfaceFormat, m_depthTextureFormat, m_frameUniforms, m_uploadScheduler);
 
-        m_selectionRenderer.init(m_device, m_queue, m_surfaceFormat, m_depthTextureFormat);
+        m_selectionRenderer.init(m_device, m_surfaceFormat, m_depthTextureFormat, m_frameUniforms);
         m_selectionRenderer.create_mesh(m_device);
 
-        m_crosshairRenderer.init(m_device, m_queue, m_surfaceFormat, m_windowWidth, m_windowHeight);
+        m_crosshairRenderer.init(m_device, m_surfaceFormat, m_windowWidth, m_windowHeight);
+
+        m_upscaleRenderer.init(m_device, m_surfaceFormat);
+        m_renderTargets.init(m_device);
 
         m_uiManager.init(m_window, m_device, m_surfaceFormat);
 
@@ -62,13 +96,19 @@ namespace flint
             1000.0f                                       // zfar
         );
 
-        init::create_depth_texture(
-            m_device,
-            m_windowWidth,
-            m_windowHeight,
-            m_depthTextureFormat,
-            &m_depthTexture,
-            &m_depthTextureView);
+        // Mesh the spawn area while the render pipelines compile.
+        m_worldRenderer.update(m_device, m_player.get_camera_position());
+
+        while (!(m_worldRenderer.isReady() && m_selectionRenderer.isReady() && m_crosshairRenderer.isReady() && m_upscaleRenderer.isReady()))
+        {
+            wgpuInstanceProcessEvents(m_instance);
+        }
+
+        std::cout << "Startup finished in " << milliseconds_since(m_startupCounter) << " ms" << std::endl;
+        if (m_pipelineCache)
+        {
+            m_pipelineCache->log_stats();
+        }
 
         // ====
         m_running = true;
@@ -83,6 +123,9 @@ namespace flint
         SDL_Event e;
         while (m_running)
         {
+            // Wait for the GPU and the frame limit before reading input, so it is as fresh as possible.
+            m_framePacer.wait_for_frame(m_instance);
+
             // Calculate delta time
             uint64_t current_tick = SDL_GetPerformanceCounter();
             float dt = static_cast<float>(current_tick - last_tick) / static_cast<float>(SDL_GetPerformanceFrequency());
@@ -96,6 +139,7 @@ namespace flint
 
             // Update player physics and state (always update - world continues even with inventory open)
             m_player.update(dt, m_worldRenderer.getWorld());
+            m_dayNightCycle.advance(dt);
 
             // Render the scene
             render();
@@ -127,31 +171,10 @@ namespace flint
         m_windowHeight = height;
 
         // Reconfigure the surface
-        WGPUSurfaceConfiguration surfaceConfig = {};
-        surfaceConfig.nextInChain = nullptr;
-        surfaceConfig.device = m_device;
-        surfaceConfig.format = m_surfaceFormat;
-        surfaceConfig.usage = WGPUTextureUsage_RenderAttachment;
-        surfaceConfig.width = m_windowWidth;
-        surfaceConfig.height = m_windowHeight;
-        surfaceConfig.presentMode = WGPUPresentMode_Fifo;
-        surfaceConfig.alphaMode = WGPUCompositeAlphaMode_Auto;
-        surfaceConfig.viewFormatCount = 0;
-        surfaceConfig.viewFormats = nullptr;
-        wgpuSurfaceConfigure(m_surface, &surfaceConfig);
-
-        // Re-create depth texture
-        if (m_depthTextureView)
-            wgpuTextureViewRelease(m_depthTextureView);
-        if (m_depthTexture)
-            wgpuTextureRelease(m_depthTexture);
-        init::create_depth_texture(
-            m_device,
-            m_windowWidth,
-            m_windowHeight,
-            m_depthTextureFormat,
-            &m_depthTexture,
-            &m_depthTextureView);
+        configure_surface();
+
+        // Render targets for the new size come from m_renderTargets on the next
+        // frame; the old ones are released once they go unused.
 
         // Update camera aspect ratio
         m_camera.aspect = (float)m_windowWidth / (float)m_windowHeight;
@@ -161,16 +184,58 @@ namespace flint
         m_crosshairRenderer.onResize(m_windowWidth, m_windowHeight);
     }
 
+    void App::configure_surface()
+    {
+        init::configure_surface(
+            m_surface,
+            m_device,
+            m_surfaceFormat,
+            m_windowWidth,
+            m_windowHeight,
+            m_framePacer.getPresentMode());
+    }
+
     void App::render()
     {
         update_camera();
 
+        // Stream chunks in around the camera and refresh their level of detail.
+        m_worldRenderer.update(m_device, m_camera.eye);
+
+        graphics::FrameStats frameStats = m_framePacer.getStats();
+        m_gpuProfiler.fill_stats(frameStats);
+
+        // The world pass renders at a scale of the window size picked from recent frame cost.
+        m_dynamicResolution.update(frameStats);
+        float renderScale = m_dynamicResolution.getScale();
+        uint32_t renderWidth = std::max(1u, static_cast<uint32_t>(m_windowWidth * renderScale + 0.5f));
+        uint32_t renderHeight = std::max(1u, static_cast<uint32_t>(m_windowHeight * renderScale + 0.5f));
+        bool upscale = renderWidth != static_cast<uint32_t>(m_windowWidth) || renderHeight != static_cast<uint32_t>(m_windowHeight);
+        frameStats.dynamicResolution = m_dynamicResolution.isEnabled();
+        frameStats.renderScale = renderScale;
+        frameStats.renderWidth = renderWidth;
+        frameStats.renderHeight = renderHeight;
+        frameStats.terrainDraws = m_worldRenderer.getDrawCount();
+        frameStats.drawSortMs = m_worldRenderer.getDrawSortMs();
+        frameStats.uploadQueueDepth = m_uploadScheduler.getQueueDepth();
+        frameStats.uploadQueuedBytes = m_uploadScheduler.getQueuedBytes();
+        frameStats.uploadBytes = m_uploadScheduler.getBytesLastFrame();
+        frameStats.gpuMemoryBytes = init::gpu_memory_used_total();
+        frameStats.chunkMeshBytes = init::gpu_memory_used(init::GpuMemoryKind::ChunkGeometry) + init::gpu_memory_used(init::GpuMemoryKind::ChunkLight);
+        frameStats.chunkMeshBudget = m_worldRenderer.getViewSettings().mesh_memory_budget;
+        frameStats.meshDistance = m_worldRenderer.getMeshDistance();
+        frameStats.viewDistance = m_worldRenderer.getViewSettings().view_distance;
+        frameStats.timeOfDay = m_dayNightCycle.getTimeOfDay();
+        frameStats.skyBrightness = m_dayNightCycle.getSkyBrightness();
+        frameStats.daySpeed = m_dayNightCycle.getSpeed();
+
         // Render all UI (UIManager handles frame lifecycle internally)
         m_uiManager.render(
             m_showDebugScreen,
             m_gameState.is_inventory_open(),
             m_player,
             m_worldRenderer.getWorld(),
+            frameStats,
             m_windowWidth,
             m_windowHeight
         );
@@ -189,20 +254,45 @@ namespace flint
 
             WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(m_device, &encoderDesc);
 
+            // Chunk origins live in persistent slots; only the selection box needs a per-frame one.
+            m_frameUniforms.set_sky_brightness(m_dayNightCycle.getSkyBrightness());
+            m_frameUniforms.begin_frame(m_device, m_camera, 1);
+            m_gpuProfiler.begin_frame();
+
+            // Mesh copies go first in the encoder, so the world pass already draws what arrived this frame.
+            m_uploadScheduler.record(encoder, m_camera.eye);
+
             // --- Main 3D Render Pass ---
-            WGPURenderPassEncoder renderPass = init::begin_render_pass(encoder, textureView, m_depthTextureView);
-            m_worldRenderer.render(renderPass, m_queue, m_camera);
+            // At full scale the world goes straight into the surface, otherwise into
+            // an offscreen target that the overlay pass stretches over the surface.
+            graphics::RenderTarget depthTarget = m_renderTargets.acquire(
+                "World Depth Target", renderWidth, renderHeight, m_depthTextureFormat, WGPUTextureUsage_RenderAttachment);
+            WGPUTextureView worldView = textureView;
+            if (upscale)
+            {
+                graphics::RenderTarget colorTarget = m_renderTargets.acquire(
+                    "World Color Target", renderWidth, renderHeight, m_surfaceFormat, WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding);
+                worldView = colorTarget.view;
+            }
+
+            WGPURenderPassEncoder renderPass = init::begin_render_pass(encoder, worldView, depthTarget.view, m_gpuProfiler.timestamp_writes(m_worldPassTimer));
+            m_worldRenderer.render(renderPass);
             auto selected_block = m_player.get_selected_block();
             std::optional<glm::ivec3> selected_block_pos;
             if (selected_block.has_value())
             {
                 selected_block_pos = selected_block->block_position;
             }
-            m_selectionRenderer.render(renderPass, m_queue, m_camera, selected_block_pos);
+            m_selectionRenderer.render(renderPass, m_frameUniforms, selected_block_pos);
             wgpuRenderPassEncoderEnd(renderPass);
 
             // --- UI Overlay Render Pass ---
-            WGPURenderPassEncoder overlayRenderPass = init::begin_overlay_render_pass(encoder, textureView);
+            WGPURenderPassEncoder overlayRenderPass = init::begin_overlay_render_pass(encoder, textureView, m_gpuProfiler.timestamp_writes(m_overlayPassTimer));
+            if (upscale)
+            {
+                // Covers the whole surface, so the UI below lands on the upscaled world.
+                m_upscaleRenderer.render(overlayRenderPass, worldView);
+            }
             m_crosshairRenderer.render(overlayRenderPass);
 
             // Render all UI (managed by UIManager)
@@ -210,14 +300,29 @@ namespace flint
 
             wgpuRenderPassEncoderEnd(overlayRenderPass);
 
+            m_gpuProfiler.resolve(encoder);
+
             WGPUCommandBufferDescriptor cmdBufferDesc = {};
             cmdBufferDesc.nextInChain = nullptr;
             cmdBufferDesc.label = {nullptr, 0};
 
             WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdBufferDesc);
+
+            // All uniforms for this frame go up in one write, ahead of the submit that reads them.
+            m_frameUniforms.upload(m_queue);
             wgpuQueueSubmit(m_queue, 1, &cmdBuffer);
+            m_framePacer.on_submit(m_queue);
+            m_gpuProfiler.after_submit();
+            m_uploadScheduler.after_submit();
 
             wgpuSurfacePresent(m_surface);
+            m_framePacer.on_present();
+
+            if (!m_firstFramePresented)
+            {
+                m_firstFramePresented = true;
+                std::cout << "Time to first frame: " << milliseconds_since(m_startupCounter) << " ms" << std::endl;
+            }
 
             // Cleanup
             wgpuCommandBufferRelease(cmdBuffer);
@@ -228,10 +333,13 @@ namespace flint
         }
 
         wgpuTextureRelease(surfaceTexture.texture);
+        m_renderTargets.end_frame();
     }
 
     void App::handle_input_event(const SDL_Event &event)
     {
+        m_framePacer.on_input_event(event);
+
         // Let UI manager process events
         m_uiManager.process_event(event);
 
@@ -261,6 +369,27 @@ namespace flint
         {
             m_showDebugScreen = !m_showDebugScreen;
         }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F4)
+        {
+            m_framePacer.cycle_present_mode();
+            configure_surface();
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F5)
+        {
+            m_framePacer.cycle_frame_limit();
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F6)
+        {
+            m_framePacer.cycle_max_frames_in_flight();
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F7)
+        {
+            m_dynamicResolution.toggle();
+        }
+        else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_F8)
+        {
+            m_dayNightCycle.cycle_speed();
+        }
         else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_E)
         {
             m_gameState.toggle_inventory();
@@ -294,10 +423,8 @@ namespace flint
                 return;
             }
 
-            if (m_player.on_mouse_click(event.button, m_worldRenderer.getWorld()))
-            {
-                m_worldRenderer.rebuild_chunk_mesh(m_device);
-            }
+            // The edit is relit and remeshed by the next WorldRenderer::update.
+            m_player.on_mouse_click(event.button, m_worldRenderer.getWorld());
         }
     }
 
@@ -313,14 +440,14 @@ namespace flint
         std::cout << "Terminating app..." << std::endl;
 
         m_uiManager.cleanup();
+        m_upscaleRenderer.cleanup();
         m_crosshairRenderer.cleanup();
         m_selectionRenderer.cleanup();
         m_worldRenderer.cleanup();
-
-        if (m_depthTextureView)
-            wgpuTextureViewRelease(m_depthTextureView);
-        if (m_depthTexture)
-            wgpuTextureRelease(m_depthTexture);
+        m_uploadScheduler.cleanup();
+        m_gpuProfiler.cleanup();
+        m_frameUniforms.cleanup();
+        m_renderTargets.cleanup();
 
         if (m_surface)
         {
@@ -2,10 +2,20 @@
 
 #include <SDL3/SDL.h>
 #include <webgpu/webgpu.h>
+#include <memory>
 
 #include "camera.h"
 #include "chunk.h"
 #include "camera.h"
+#include "init/pipeline_cache.h"
+#include "frame_pacer.h"
+#include "day_night_cycle.h"
+#include "graphics/frame_uniforms.h"
+#include "graphics/upload_scheduler.h"
+#include "graphics/gpu_profiler.h"
+#include "graphics/render_target_pool.h"
+#include "graphics/dynamic_resolution.h"
+#include "graphics/upscale_renderer.h"
 #include "graphics/world_renderer.h"
 #include "graphics/selection_renderer.h"
 #include "graphics/crosshair_renderer.h"
@@ -28,6 +38,7 @@ namespace flint
         void render();
         void update_camera();
         void onResize(int width, int height);
+        void configure_surface();
         void handle_input_event(const SDL_Event &event);
         void sync_mouse_state();
 
@@ -35,6 +46,9 @@ namespace flint
         // SDL resources
         SDL_Window *m_window = nullptr;
 
+        // Dawn calls into the cache until ~App releases the device, so it lives as long as the App.
+        std::unique_ptr<init::PipelineCache> m_pipelineCache;
+
         // WebGPU resources
         WGPUInstance m_instance = nullptr;
         WGPUAdapter m_adapter = nullptr;
@@ -43,25 +57,45 @@ namespace flint
         WGPUSurface m_surface = nullptr;
         WGPUTextureFormat m_surfaceFormat;
 
-        // Depth texture for the main render pass.
-        // This is owned by the App class because its lifecycle is tied to the
-        // application window's size and the main render loop. It is passed to
-        // the WorldRenderer, which uses it as the depth attachment.
-        WGPUTexture m_depthTexture = nullptr;
-        WGPUTextureView m_depthTextureView = nullptr;
+        // Depth and offscreen color targets for the world pass.
+        // They follow the window size times the dynamic resolution scale, so
+        // the pool hands out whatever size the current frame needs and drops
+        // sizes that are no longer used.
+        graphics::RenderTargetPool m_renderTargets;
         WGPUTextureFormat m_depthTextureFormat = WGPUTextureFormat_Depth24Plus;
+        graphics::DynamicResolution m_dynamicResolution;
+
+        // Per-frame uniform ring shared by the 3D renderers (camera + per-draw slots).
+        graphics::FrameUniforms m_frameUniforms;
+        // Spreads chunk mesh uploads over frames, nearest chunks first.
+        graphics::UploadScheduler m_uploadScheduler;
 
         graphics::WorldRenderer m_worldRenderer;
         graphics::SelectionRenderer m_selectionRenderer;
         graphics::CrosshairRenderer m_crosshairRenderer;
+        graphics::UpscaleRenderer m_upscaleRenderer;
         ui::UIManager m_uiManager;
 
+        // Per-pass GPU times for the debug screen.
+        graphics::GpuProfiler m_gpuProfiler;
+        uint32_t m_worldPassTimer = 0;
+        uint32_t m_overlayPassTimer = 0;
+
+        // Present mode, frame limit and frames-in-flight cap (F4/F5/F6), plus input latency.
+        FramePacer m_framePacer;
+
+        // Time of day; only the sky brightness uniform follows it (F8 changes the speed).
+        DayNightCycle m_dayNightCycle;
+
         Camera m_camera;
         player::Player m_player;
         GameState m_gameState;
 
         // App state
         bool m_running = false;
+        // Performance counter at the start of the constructor, for time-to-first-frame.
+        uint64_t m_startupCounter = 0;
+        bool m_firstFramePresented = false;
         bool m_showDebugScreen = false;
         int m_windowWidth = 800;
         int m_windowHeight = 600;
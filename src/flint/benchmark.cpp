@@ -0,0 +1,270 @@
+#include "benchmark.h"
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "init/wgpu.h"
+#include "init/pipeline.h"
+#include "init/texture.h"
+#include "init/utils.h"
+#include "benchmark_utils.h"
+
+namespace flint
+{
+    namespace
+    {
+        using bench::Clock;
+        using bench::elapsed_ms;
+        using bench::percentile;
+
+        void OnQueueWorkDone(WGPUQueueWorkDoneStatus, void *userdata1, void *)
+        {
+            *static_cast<bool *>(userdata1) = true;
+        }
+    }
+
+    BenchmarkOptions BenchmarkOptions::from_args(int argc, char **argv)
+    {
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--frames" && hasValue)
+                options.frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--width" && hasValue)
+                options.width = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--height" && hasValue)
+                options.height = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--output" && hasValue)
+                options.outputPath = argv[++i];
+            else if (arg == "--hardware")
+                options.forceFallbackAdapter = false;
+            else if (arg == "--mesh-budget-mib" && hasValue)
+                options.meshBudgetMiB = std::stoull(argv[++i]);
+        }
+        return options;
+    }
+
+    Benchmark::Benchmark(const BenchmarkOptions &options) : m_options(options)
+    {
+        std::cout << "Initializing headless benchmark..." << std::endl;
+
+        init::wgpu_headless(m_options.forceFallbackAdapter, m_instance, m_adapter, m_device, m_queue);
+
+        WGPUAdapterInfo info = {};
+        if (wgpuAdapterGetInfo(m_adapter, &info) == WGPUStatus_Success)
+        {
+            if (info.device.data)
+            {
+                m_adapterName.assign(info.device.data, info.device.length);
+            }
+            wgpuAdapterInfoFreeMembers(info);
+        }
+        std::cout << "Benchmark adapter: " << m_adapterName << std::endl;
+
+        // Offscreen color target standing in for the swapchain image
+        WGPUTextureDescriptor colorDesc = {};
+        colorDesc.label = init::makeStringView("Benchmark Color Target");
+        colorDesc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_CopySrc;
+        colorDesc.dimension = WGPUTextureDimension_2D;
+        colorDesc.size = {m_options.width, m_options.height, 1};
+        colorDesc.format = m_colorFormat;
+        colorDesc.mipLevelCount = 1;
+        colorDesc.sampleCount = 1;
+        m_colorTexture = wgpuDeviceCreateTexture(m_device, &colorDesc);
+        m_colorTextureView = wgpuTextureCreateView(m_colorTexture, nullptr);
+
+        init::create_depth_texture(
+            m_device,
+            m_options.width,
+            m_options.height,
+            m_depthTextureFormat,
+            &m_depthTexture,
+            &m_depthTextureView);
+
+        m_frameUniforms.init(m_device);
+        m_uploadScheduler.init(m_device);
+        m_worldRenderer.init(m_device, m_queue, m_colorFormat, m_depthTextureFormat, m_frameUniforms, m_uploadScheduler);
+        if (m_options.meshBudgetMiB > 0)
+        {
+            graphics::ViewSettings settings = m_worldRenderer.getViewSettings();
+            settings.mesh_memory_budget = m_options.meshBudgetMiB * 1024 * 1024;
+            m_worldRenderer.setViewSettings(settings);
+        }
+        while (!m_worldRenderer.isReady())
+        {
+            wgpuInstanceProcessEvents(m_instance);
+        }
+
+        std::cout << "Headless benchmark initialized." << std::endl;
+    }
+
+    Benchmark::~Benchmark()
+    {
+        std::cout << "Cleaning up headless benchmark..." << std::endl;
+
+        m_worldRenderer.cleanup();
+        m_uploadScheduler.cleanup();
+        m_frameUniforms.cleanup();
+
+        if (m_depthTextureView)
+            wgpuTextureViewRelease(m_depthTextureView);
+        if (m_depthTexture)
+            wgpuTextureRelease(m_depthTexture);
+        if (m_colorTextureView)
+            wgpuTextureViewRelease(m_colorTextureView);
+        if (m_colorTexture)
+            wgpuTextureRelease(m_colorTexture);
+
+        if (m_queue)
+            wgpuQueueRelease(m_queue);
+        if (m_device)
+            wgpuDeviceRelease(m_device);
+        if (m_adapter)
+            wgpuAdapterRelease(m_adapter);
+        if (m_instance)
+            wgpuInstanceRelease(m_instance);
+    }
+
+    Camera Benchmark::camera_for_frame(uint32_t frame) const
+    {
+        // A fixed 60 Hz timeline, so runs are comparable regardless of speed.
+        // The camera flies along +X above the terrain, weaving in Z and turning
+        // its view, which crosses chunk borders and exercises streaming and LOD.
+        const float t = static_cast<float>(frame) / 60.0f;
+        glm::vec3 eye(8.0f + t * 12.0f, 40.0f, 8.0f + 24.0f * std::sin(t * 0.25f));
+
+        float yaw = t * 0.4f;
+        glm::vec3 forward = glm::normalize(glm::vec3(std::cos(yaw), -0.35f, std::sin(yaw)));
+
+        return Camera(
+            eye,
+            eye + forward,
+            {0.0f, 1.0f, 0.0f},
+            static_cast<float>(m_options.width) / static_cast<float>(m_options.height),
+            60.0f,
+            0.1f,
+            1000.0f);
+    }
+
+    void Benchmark::wait_for_queue()
+    {
+        bool done = false;
+
+        WGPUQueueWorkDoneCallbackInfo callbackInfo = {};
+        callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        callbackInfo.callback = OnQueueWorkDone;
+        callbackInfo.userdata1 = &done;
+        wgpuQueueOnSubmittedWorkDone(m_queue, callbackInfo);
+
+        while (!done)
+        {
+            wgpuInstanceProcessEvents(m_instance);
+        }
+    }
+
+    void Benchmark::run()
+    {
+        std::cout << "Running headless benchmark for " << m_options.frames << " frames..." << std::endl;
+
+        std::vector<FrameTiming> timings;
+        timings.reserve(m_options.frames);
+
+        for (uint32_t frame = 0; frame < m_options.frames; ++frame)
+        {
+            Clock::time_point cpuStart = Clock::now();
+
+            Camera camera = camera_for_frame(frame);
+            m_worldRenderer.update(m_device, camera.eye);
+
+            WGPUCommandEncoderDescriptor encoderDesc = {};
+            WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(m_device, &encoderDesc);
+
+            m_frameUniforms.begin_frame(m_device, camera, 0);
+            m_uploadScheduler.record(encoder, camera.eye);
+
+            WGPURenderPassEncoder renderPass = init::begin_render_pass(encoder, m_colorTextureView, m_depthTextureView);
+            m_worldRenderer.render(renderPass);
+            wgpuRenderPassEncoderEnd(renderPass);
+
+            WGPUCommandBufferDescriptor cmdBufferDesc = {};
+            WGPUCommandBuffer cmdBuffer = wgpuCommandEncoderFinish(encoder, &cmdBufferDesc);
+
+            m_frameUniforms.upload(m_queue);
+            wgpuQueueSubmit(m_queue, 1, &cmdBuffer);
+            m_uploadScheduler.after_submit();
+
+            Clock::time_point cpuEnd = Clock::now();
+
+            wait_for_queue();
+
+            Clock::time_point gpuEnd = Clock::now();
+
+            wgpuCommandBufferRelease(cmdBuffer);
+            wgpuRenderPassEncoderRelease(renderPass);
+            wgpuCommandEncoderRelease(encoder);
+
+            timings.push_back({elapsed_ms(cpuStart, cpuEnd), elapsed_ms(cpuEnd, gpuEnd)});
+        }
+
+        write_report(timings);
+    }
+
+    void Benchmark::write_report(const std::vector<FrameTiming> &timings) const
+    {
+        std::vector<double> cpu;
+        std::vector<double> gpu;
+        for (const FrameTiming &timing : timings)
+        {
+            cpu.push_back(timing.cpu_ms);
+            gpu.push_back(timing.gpu_ms);
+        }
+
+        std::ofstream out(m_options.outputPath);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to open benchmark output: " + m_options.outputPath);
+        }
+
+        std::string adapter;
+        for (char c : m_adapterName)
+        {
+            if (c == '"' || c == '\\')
+                adapter += '\\';
+            adapter += c;
+        }
+
+        out << "{\n";
+        out << "  \"adapter\": \"" << adapter << "\",\n";
+        out << "  \"fallback_adapter\": " << (m_options.forceFallbackAdapter ? "true" : "false") << ",\n";
+        out << "  \"width\": " << m_options.width << ",\n";
+        out << "  \"height\": " << m_options.height << ",\n";
+        out << "  \"view_distance\": " << m_worldRenderer.getViewSettings().view_distance << ",\n";
+        out << "  \"summary\": {\n";
+        out << "    \"cpu_ms_mean\": " << bench::mean(cpu) << ",\n";
+        out << "    \"cpu_ms_p50\": " << percentile(cpu, 0.50) << ",\n";
+        out << "    \"cpu_ms_p95\": " << percentile(cpu, 0.95) << ",\n";
+        out << "    \"gpu_ms_mean\": " << bench::mean(gpu) << ",\n";
+        out << "    \"gpu_ms_p50\": " << percentile(gpu, 0.50) << ",\n";
+        out << "    \"gpu_ms_p95\": " << percentile(gpu, 0.95) << "\n";
+        out << "  },\n";
+        out << "  \"frames\": [\n";
+        for (size_t i = 0; i < timings.size(); ++i)
+        {
+            out << "    {\"frame\": " << i
+                << ", \"cpu_ms\": " << timings[i].cpu_ms
+                << ", \"gpu_ms\": " << timings[i].gpu_ms << "}"
+                << (i + 1 < timings.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n";
+        out << "}\n";
+
+        std::cout << "Benchmark report written to " << m_options.outputPath << std::endl;
+    }
+
+} // namespace flint
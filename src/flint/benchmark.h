@@ -0,0 +1,76 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+#include "graphics/frame_uniforms.h"
+#include "graphics/upload_scheduler.h"
+#include "graphics/world_renderer.h"
+
+namespace flint
+{
+
+    struct BenchmarkOptions
+    {
+        uint32_t width = 1280;
+        uint32_t height = 720;
+        uint32_t frames = 600;
+        // Dawn's software adapter, so the benchmark runs on machines without a GPU.
+        bool forceFallbackAdapter = true;
+        std::string outputPath = "benchmark.json";
+        // Chunk mesh memory budget; 0 keeps the renderer's default.
+        uint64_t meshBudgetMiB = 0;
+
+        // Parses `--frames N --width N --height N --output PATH --hardware --mesh-budget-mib N`.
+        static BenchmarkOptions from_args(int argc, char **argv);
+    };
+
+    // Renders the world headlessly into an offscreen texture along a scripted
+    // camera path and writes per-frame CPU and GPU times as JSON.
+    //
+    // CPU time covers world streaming, meshing, encoding and submit. GPU time is
+    // measured from submit until the queue reports the frame's work as done, so
+    // every frame is waited on before the next one starts.
+    class Benchmark
+    {
+    public:
+        explicit Benchmark(const BenchmarkOptions &options);
+        ~Benchmark();
+
+        void run();
+
+    private:
+        struct FrameTiming
+        {
+            double cpu_ms;
+            double gpu_ms;
+        };
+
+        Camera camera_for_frame(uint32_t frame) const;
+        void wait_for_queue();
+        void write_report(const std::vector<FrameTiming> &timings) const;
+
+        BenchmarkOptions m_options;
+
+        WGPUInstance m_instance = nullptr;
+        WGPUAdapter m_adapter = nullptr;
+        WGPUDevice m_device = nullptr;
+        WGPUQueue m_queue = nullptr;
+        std::string m_adapterName;
+
+        WGPUTextureFormat m_colorFormat = WGPUTextureFormat_BGRA8Unorm;
+        WGPUTexture m_colorTexture = nullptr;
+        WGPUTextureView m_colorTextureView = nullptr;
+        WGPUTextureFormat m_depthTextureFormat = WGPUTextureFormat_Depth24Plus;
+        WGPUTexture m_depthTexture = nullptr;
+        WGPUTextureView m_depthTextureView = nullptr;
+
+        graphics::FrameUniforms m_frameUniforms;
+        graphics::UploadScheduler m_uploadScheduler;
+        graphics::WorldRenderer m_worldRenderer;
+    };
+
+} // namespace flint
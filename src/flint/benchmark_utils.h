@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "world.h"
+
+// Shared by the frame benchmark, the light benchmark and tools/light_check.
+// Needs no window or GPU.
+namespace flint::bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double elapsed_ms(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    inline double percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t index = static_cast<size_t>(std::ceil(p * values.size())) - 1;
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    inline double mean(const std::vector<double> &values)
+    {
+        double total = 0.0;
+        for (double value : values)
+        {
+            total += value;
+        }
+        return values.empty() ? 0.0 : total / values.size();
+    }
+
+    // Chunks loaded around the center of an edit world. Edits stay in the
+    // inner 3x3 chunks, so their light never runs into unloaded ground.
+    constexpr int EDIT_WORLD_RADIUS = 2;
+    constexpr int EDIT_AREA = 3 * static_cast<int>(CHUNK_WIDTH);
+
+    // Height of the top-most solid block in a column, or -1 if there is none.
+    inline int surface_height(const World &world, int x, int z)
+    {
+        for (int y = static_cast<int>(CHUNK_HEIGHT) - 1; y >= 0; --y)
+        {
+            if (world.is_solid(x, y, z))
+            {
+                return y;
+            }
+        }
+        return -1;
+    }
+
+    // A fixed LCG, so edit sequences are the same on every platform and run.
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        // Uniform in [0, range).
+        int next(int range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return static_cast<int>((m_state >> 8) % static_cast<uint32_t>(range));
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+} // namespace flint::bench
@@ -12,6 +12,7 @@ namespace flint
         case BlockType::Grass:
         case BlockType::Dirt:
         case BlockType::OakLog:
+        case BlockType::Glowstone:
             return true;
         case BlockType::Air:
         case BlockType::OakLeaves:
@@ -25,4 +26,15 @@ namespace flint
         return !isSolid();
     }
 
+    uint8_t Block::emission() const
+    {
+        switch (type)
+        {
+        case BlockType::Glowstone:
+            return 15;
+        default:
+            return 0;
+        }
+    }
+
 } // namespace flint
\ No newline at end of file
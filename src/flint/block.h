@@ -12,14 +12,15 @@ namespace flint
         Dirt,
     Grass,
     OakLog,
-    OakLeaves
+    OakLeaves,
+    Glowstone
     };
 
     // This is the C++ equivalent of your Rust `pub struct Block`.
     struct Block
     {
+        // Its light lives with the chunk (Chunk::sky_light, Chunk::block_light).
         BlockType type;
-        uint8_t sky_light = 0;
 
         // Constructor, equivalent to `Block::new`.
         explicit Block(BlockType block_type = BlockType::Air);
@@ -27,6 +28,8 @@ namespace flint
         // A const member function, equivalent to `is_solid(&self)`.
         bool isSolid() const;
         bool isTransparent() const;
+        // The block light this block gives off, 0 for everything but light sources.
+        uint8_t emission() const;
     };
 
 } // namespace flint
\ No newline at end of file
@@ -1,22 +1,109 @@
 #include "chunk.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace flint
 {
+    namespace
+    {
+        // Height of the terrain surface at a world column.
+        // Gentle hills fade in away from the spawn chunk, so the physics test
+        // props placed in chunk (0, 0) keep standing on level ground.
+        size_t terrain_height(int world_x, int world_z)
+        {
+            const float surface_level = static_cast<float>(CHUNK_HEIGHT / 2);
+
+            float dx = static_cast<float>(world_x) - CHUNK_WIDTH / 2.0f;
+            float dz = static_cast<float>(world_z) - CHUNK_DEPTH / 2.0f;
+            float distance = std::sqrt(dx * dx + dz * dz);
+            float falloff = std::clamp((distance - CHUNK_WIDTH) / (2.0f * CHUNK_WIDTH), 0.0f, 1.0f);
+
+            float hills = 3.0f * std::sin(world_x * 0.07f) +
+                          3.0f * std::cos(world_z * 0.05f) +
+                          1.5f * std::sin((world_x + world_z) * 0.13f);
+
+            return static_cast<size_t>(std::lround(surface_level + hills * falloff));
+        }
+    } // namespace
+
+    SectionLight::SectionLight(const SectionLight &other)
+        : m_nibbles(other.m_nibbles ? std::make_unique<Nibbles>(*other.m_nibbles) : nullptr),
+          m_uniform(other.m_uniform)
+    {
+    }
+
+    SectionLight &SectionLight::operator=(const SectionLight &other)
+    {
+        if (this != &other)
+        {
+            m_nibbles = other.m_nibbles ? std::make_unique<Nibbles>(*other.m_nibbles) : nullptr;
+            m_uniform = other.m_uniform;
+        }
+        return *this;
+    }
+
+    void SectionLight::fill(uint8_t light)
+    {
+        m_nibbles.reset();
+        m_uniform = light;
+    }
+
+    void SectionLight::assign(const uint8_t *light)
+    {
+        if (std::memcmp(light, light + 1, SECTION_VOLUME - 1) == 0)
+        {
+            fill(light[0]);
+            return;
+        }
+        if (!m_nibbles)
+        {
+            m_nibbles.reset(new Nibbles);
+        }
+        for (size_t i = 0; i < m_nibbles->size(); ++i)
+        {
+            (*m_nibbles)[i] = static_cast<uint8_t>(light[2 * i] | light[2 * i + 1] << 4);
+        }
+    }
+
+    void SectionLight::compact()
+    {
+        if (!m_nibbles)
+        {
+            return;
+        }
+        // Every byte equals the one after it, and both nibbles of the first agree.
+        const uint8_t *pairs = m_nibbles->data();
+        if ((pairs[0] >> 4) != (pairs[0] & 0x0F) || std::memcmp(pairs, pairs + 1, m_nibbles->size() - 1) != 0)
+        {
+            return;
+        }
+        fill(pairs[0] & 0x0F);
+    }
+
+    void SectionLight::split()
+    {
+        m_nibbles.reset(new Nibbles);
+        m_nibbles->fill(static_cast<uint8_t>(m_uniform | m_uniform << 4));
+    }
 
     // The constructor.
     // Because our `Block` struct has a default constructor that sets the type to Air,
     // the `m_blocks` array is automatically filled with Air blocks when a Chunk is created.
     // Therefore, the constructor body can be empty.
-    Chunk::Chunk() {}
+    Chunk::Chunk(int chunk_x, int chunk_z) : m_chunk_x(chunk_x), m_chunk_z(chunk_z) {}
 
     void Chunk::generateTerrain()
     {
-        const size_t surface_level = CHUNK_HEIGHT / 2;
-
         for (size_t x = 0; x < CHUNK_WIDTH; ++x)
         {
             for (size_t z = 0; z < CHUNK_DEPTH; ++z)
             {
+                const size_t surface_level = terrain_height(
+                    m_chunk_x * static_cast<int>(CHUNK_WIDTH) + static_cast<int>(x),
+                    m_chunk_z * static_cast<int>(CHUNK_DEPTH) + static_cast<int>(z));
+
                 for (size_t y = 0; y < CHUNK_HEIGHT; ++y)
                 {
                     if (y < surface_level)
@@ -32,6 +119,14 @@ namespace flint
             }
         }
 
+        // The hardcoded test props only live in the spawn chunk.
+        if (m_chunk_x != 0 || m_chunk_z != 0)
+        {
+            return;
+        }
+
+        const size_t surface_level = CHUNK_HEIGHT / 2;
+
         // Add hardcoded pillars for testing physics
         const size_t pillar_y_start = surface_level + 1;
 
@@ -135,4 +230,35 @@ namespace flint
         return false;
     }
 
+    void Chunk::queue_border_light(int side, const glm::ivec3 &local)
+    {
+        static_assert(CHUNK_WIDTH == CHUNK_DEPTH, "every border face must have the same size");
+        const int along = side == CHUNK_SIDE_NEG_X || side == CHUNK_SIDE_POS_X ? local.z : local.x;
+        const size_t bit = static_cast<size_t>(local.y) * CHUNK_WIDTH + static_cast<size_t>(along);
+        if (m_pendingBorderLightQueued[side].test(bit))
+        {
+            return;
+        }
+        m_pendingBorderLightQueued[side].set(bit);
+        m_pendingBorderLight[side].push_back(local);
+    }
+
+    std::vector<glm::ivec3> Chunk::take_border_light(int side)
+    {
+        std::vector<glm::ivec3> pending;
+        pending.swap(m_pendingBorderLight[side]);
+        m_pendingBorderLightQueued[side].reset();
+        return pending;
+    }
+
+    size_t Chunk::light_bytes() const
+    {
+        size_t bytes = 0;
+        for (size_t section = 0; section < SECTION_COUNT; ++section)
+        {
+            bytes += m_skyLight[section].allocated_bytes() + m_blockLight[section].allocated_bytes();
+        }
+        return bytes;
+    }
+
 } // namespace flint
\ No newline at end of file
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "block.h"
+#include <array>
+#include <bitset>
 #include <cstddef> // For size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
 
 namespace flint
 {
@@ -12,15 +18,110 @@ namespace flint
     constexpr size_t CHUNK_HEIGHT = 32;
     constexpr size_t CHUNK_DEPTH = 16;
 
+    // Light is stored per section: a slab of SECTION_HEIGHT layers across the chunk.
+    constexpr size_t SECTION_HEIGHT = 8;
+    constexpr size_t SECTION_COUNT = CHUNK_HEIGHT / SECTION_HEIGHT;
+    constexpr size_t SECTION_VOLUME = CHUNK_WIDTH * SECTION_HEIGHT * CHUNK_DEPTH;
+    static_assert(CHUNK_HEIGHT % SECTION_HEIGHT == 0);
+
+    // The four horizontal sides of a chunk, in the same order as the mesher's neighbours.
+    // `side ^ 1` is the opposite side.
+    enum ChunkSide
+    {
+        CHUNK_SIDE_NEG_X = 0,
+        CHUNK_SIDE_POS_X = 1,
+        CHUNK_SIDE_NEG_Z = 2,
+        CHUNK_SIDE_POS_Z = 3,
+        CHUNK_SIDE_COUNT = 4,
+    };
+
+    // An inclusive box of blocks in world coordinates.
+    struct BlockBox
+    {
+        glm::ivec3 min;
+        glm::ivec3 max;
+
+        void include(const BlockBox &other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+    };
+
+    // One light channel (0-15 per block) of a section. While all its blocks
+    // share a value that value is all there is; the first write of a different
+    // one allocates a nibble per block. Most sections are open sky at 15 or
+    // solid ground at 0, and almost none hold any block light.
+    class SectionLight
+    {
+    public:
+        SectionLight() = default;
+        SectionLight(const SectionLight &other);
+        SectionLight &operator=(const SectionLight &other);
+        SectionLight(SectionLight &&) = default;
+        SectionLight &operator=(SectionLight &&) = default;
+
+        // `index` is (x * SECTION_HEIGHT + y) * CHUNK_DEPTH + z, y within the section.
+        uint8_t get(size_t index) const
+        {
+            if (!m_nibbles)
+            {
+                return m_uniform;
+            }
+            uint8_t pair = (*m_nibbles)[index / 2];
+            return index % 2 ? pair >> 4 : pair & 0x0F;
+        }
+
+        void set(size_t index, uint8_t light)
+        {
+            if (!m_nibbles)
+            {
+                if (light == m_uniform)
+                {
+                    return;
+                }
+                split();
+            }
+            uint8_t &pair = (*m_nibbles)[index / 2];
+            pair = index % 2 ? static_cast<uint8_t>((pair & 0x0F) | light << 4) : static_cast<uint8_t>((pair & 0xF0) | light);
+        }
+
+        // Gives every block `light`, freeing the nibbles.
+        void fill(uint8_t light);
+        // Takes the light of all SECTION_VOLUME blocks at once, a byte each in index order.
+        void assign(const uint8_t *light);
+        // Frees the nibbles if every block ended up with the same light.
+        void compact();
+
+        bool is_uniform() const { return !m_nibbles; }
+        // The light of every block, while is_uniform().
+        uint8_t uniform_light() const { return m_uniform; }
+        // Heap bytes held, 0 while uniform.
+        size_t allocated_bytes() const { return m_nibbles ? sizeof(Nibbles) : 0; }
+
+    private:
+        using Nibbles = std::array<uint8_t, SECTION_VOLUME / 2>;
+
+        void split();
+
+        std::unique_ptr<Nibbles> m_nibbles;
+        uint8_t m_uniform = 0;
+    };
+
     class Chunk
     {
     public:
         // Constructor, equivalent to `new()` and the `Default` trait implementation.
-        Chunk();
+        // `chunk_x`/`chunk_z` are the chunk's coordinates in chunk units, so the
+        // block at local (0, y, 0) sits at world (chunk_x * CHUNK_WIDTH, y, chunk_z * CHUNK_DEPTH).
+        Chunk(int chunk_x = 0, int chunk_z = 0);
 
         // Member function to generate the chunk's terrain.
         void generateTerrain();
 
+        int getChunkX() const { return m_chunk_x; }
+        int getChunkZ() const { return m_chunk_z; }
+
         // Gets a read-only pointer to a block.
         // Returning a pointer (`const Block*`) is the C++ equivalent of Rust's `Option<&Block>`.
         // It will be `nullptr` if the coordinates are out of bounds.
@@ -32,14 +133,68 @@ namespace flint
         // It returns `true` on success and `false` on failure (out of bounds).
         bool setBlock(int x, int y, int z, BlockType type);
 
+        // All blocks in storage order, at index (x * CHUNK_HEIGHT + y) * CHUNK_DEPTH + z.
+        // For tight loops that handle bounds themselves, such as the light engine's.
+        Block *blocks() { return &m_blocks[0][0][0]; }
+        const Block *blocks() const { return &m_blocks[0][0][0]; }
+
+        static constexpr size_t block_index(size_t x, size_t y, size_t z)
+        {
+            return (x * CHUNK_HEIGHT + y) * CHUNK_DEPTH + z;
+        }
+
+        // Light by index into blocks(), 0-15. Block light (from emissive blocks)
+        // is kept apart from sky light so only the latter follows the day/night
+        // cycle. Each section stores both channels on its own (SectionLight).
+        uint8_t sky_light(size_t index) const { return m_skyLight[section_of(index)].get(index_in_section(index)); }
+        uint8_t block_light(size_t index) const { return m_blockLight[section_of(index)].get(index_in_section(index)); }
+        void set_sky_light(size_t index, uint8_t light) { m_skyLight[section_of(index)].set(index_in_section(index), light); }
+        void set_block_light(size_t index, uint8_t light) { m_blockLight[section_of(index)].set(index_in_section(index), light); }
+
+        SectionLight &sky_section(size_t section) { return m_skyLight[section]; }
+        const SectionLight &sky_section(size_t section) const { return m_skyLight[section]; }
+        SectionLight &block_section(size_t section) { return m_blockLight[section]; }
+        const SectionLight &block_section(size_t section) const { return m_blockLight[section]; }
+
+        static constexpr size_t section_of(size_t index)
+        {
+            return index / CHUNK_DEPTH % CHUNK_HEIGHT / SECTION_HEIGHT;
+        }
+        static constexpr size_t index_in_section(size_t index)
+        {
+            size_t x = index / (CHUNK_HEIGHT * CHUNK_DEPTH);
+            size_t y = index / CHUNK_DEPTH % SECTION_HEIGHT;
+            return (x * SECTION_HEIGHT + y) * CHUNK_DEPTH + index % CHUNK_DEPTH;
+        }
+
+        // Heap bytes held by the chunk's light nibbles.
+        size_t light_bytes() const;
+
         // Checks if a block at the given world coordinates is solid.
         // This is a new method for physics checks.
         bool is_solid(int x, int y, int z) const;
 
+        // Border blocks whose light still has to be offered to the neighbour
+        // on `side`, in local coordinates. They pile up while that neighbour is
+        // not loaded and are handed over when it is (see Light::exchange_border_light).
+        // Each block is queued at most once, however often light reaches it.
+        void queue_border_light(int side, const glm::ivec3 &local);
+        std::vector<glm::ivec3> take_border_light(int side);
+
     private:
+        int m_chunk_x;
+        int m_chunk_z;
+
         // A 3D C-style array is much more efficient than a Vec<Vec<Vec<...>>>
         // for a fixed-size grid. It allocates all blocks in a single contiguous memory block.
         Block m_blocks[CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
+
+        std::array<SectionLight, SECTION_COUNT> m_skyLight;
+        std::array<SectionLight, SECTION_COUNT> m_blockLight;
+
+        std::array<std::vector<glm::ivec3>, CHUNK_SIDE_COUNT> m_pendingBorderLight;
+        // Which blocks of each border face are in m_pendingBorderLight, at y * CHUNK_WIDTH + the coordinate along the side.
+        std::array<std::bitset<CHUNK_HEIGHT * CHUNK_WIDTH>, CHUNK_SIDE_COUNT> m_pendingBorderLightQueued;
     };
 
 } // namespace flint
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "day_night_cycle.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+#include <iterator>
+
+namespace flint
+{
+    namespace
+    {
+        // Multipliers cycled through at runtime; 60x makes a day take 20 seconds.
+        constexpr float SPEEDS[] = {1.0f, 60.0f, 0.0f};
+
+        // Sky light never drops below this at night, so caves stay the darkest places.
+        constexpr float NIGHT_BRIGHTNESS = 0.15f;
+    }
+
+    void DayNightCycle::advance(float dt)
+    {
+        m_timeOfDay += dt * getSpeed() / DAY_LENGTH_SECONDS;
+        m_timeOfDay -= std::floor(m_timeOfDay);
+    }
+
+    void DayNightCycle::cycle_speed()
+    {
+        m_speedIndex = (m_speedIndex + 1) % static_cast<int>(std::size(SPEEDS));
+    }
+
+    float DayNightCycle::getSpeed() const
+    {
+        return SPEEDS[m_speedIndex];
+    }
+
+    float DayNightCycle::getSkyBrightness() const
+    {
+        // Height of the sun: -1 at midnight, 1 at noon. Dusk and dawn fade over
+        // the stretch where the sun is just below or above the horizon.
+        float sunHeight = -std::cos(m_timeOfDay * 2.0f * glm::pi<float>());
+        float day = glm::smoothstep(-0.2f, 0.3f, sunHeight);
+        return glm::mix(NIGHT_BRIGHTNESS, 1.0f, day);
+    }
+
+} // namespace flint
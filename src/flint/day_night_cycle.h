@@ -0,0 +1,34 @@
+#pragma once
+
+namespace flint
+{
+
+    // The world clock behind the sky brightness.
+    //
+    // Time of day runs from 0 to 1: 0 is midnight, 0.25 sunrise, 0.5 noon and
+    // 0.75 sunset. Sky light baked into the chunks stays the same all day; the
+    // renderer scales it by `getSkyBrightness` in the shader, so the day passing
+    // costs one float per frame and never a remesh or a relight.
+    class DayNightCycle
+    {
+    public:
+        void advance(float dt);
+
+        // Steps through normal speed, fast-forward and paused.
+        void cycle_speed();
+
+        float getTimeOfDay() const { return m_timeOfDay; }
+        // 1 at full daylight, down to a dim floor at night.
+        float getSkyBrightness() const;
+        float getSpeed() const;
+
+    private:
+        // A full day in real seconds at normal speed.
+        static constexpr float DAY_LENGTH_SECONDS = 20.0f * 60.0f;
+
+        // Start in the morning so a new session isn't dark.
+        float m_timeOfDay = 0.3f;
+        int m_speedIndex = 0;
+    };
+
+} // namespace flint
@@ -0,0 +1,190 @@
+#include "frame_pacer.h"
+
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace flint
+{
+    namespace
+    {
+        // Frame rate limits cycled through at runtime, 0 = uncapped.
+        constexpr uint32_t FRAME_LIMITS[] = {0, 30, 60, 120, 144};
+        constexpr uint32_t MAX_FRAMES_IN_FLIGHT_LIMIT = 3;
+        constexpr uint64_t NS_PER_SECOND = 1000000000ull;
+        // How much each new sample moves the smoothed values.
+        constexpr double SMOOTHING = 0.1;
+
+        const char *present_mode_name(WGPUPresentMode mode)
+        {
+            switch (mode)
+            {
+            case WGPUPresentMode_Fifo:
+                return "Fifo";
+            case WGPUPresentMode_FifoRelaxed:
+                return "FifoRelaxed";
+            case WGPUPresentMode_Immediate:
+                return "Immediate";
+            case WGPUPresentMode_Mailbox:
+                return "Mailbox";
+            default:
+                return "Unknown";
+            }
+        }
+
+        double smooth(double current, double sample)
+        {
+            return current == 0.0 ? sample : current + (sample - current) * SMOOTHING;
+        }
+    }
+
+    void FramePacer::init(std::vector<WGPUPresentMode> supportedPresentModes)
+    {
+        // Only offer the modes we have a use for: Fifo (vsync, never tears),
+        // Mailbox (vsync, newest frame wins) and Immediate (lowest latency, tears).
+        m_presentModes.clear();
+        for (WGPUPresentMode mode : {WGPUPresentMode_Fifo, WGPUPresentMode_Mailbox, WGPUPresentMode_Immediate})
+        {
+            if (std::find(supportedPresentModes.begin(), supportedPresentModes.end(), mode) != supportedPresentModes.end())
+            {
+                m_presentModes.push_back(mode);
+            }
+        }
+        // Fifo is required by the spec, keep it even if the list came back empty.
+        if (m_presentModes.empty() || m_presentModes.front() != WGPUPresentMode_Fifo)
+        {
+            m_presentModes.insert(m_presentModes.begin(), WGPUPresentMode_Fifo);
+        }
+        m_presentModeIndex = 0;
+
+        std::cout << "Supported present modes:";
+        for (WGPUPresentMode mode : m_presentModes)
+        {
+            std::cout << " " << present_mode_name(mode);
+        }
+        std::cout << std::endl;
+
+        m_stats.presentMode = present_mode_name(getPresentMode());
+        m_stats.frameLimit = FRAME_LIMITS[m_frameLimitIndex];
+        m_stats.maxFramesInFlight = m_maxFramesInFlight;
+    }
+
+    void FramePacer::cycle_present_mode()
+    {
+        m_presentModeIndex = (m_presentModeIndex + 1) % m_presentModes.size();
+        m_stats.presentMode = present_mode_name(getPresentMode());
+        std::cout << "Present mode: " << m_stats.presentMode << std::endl;
+    }
+
+    void FramePacer::cycle_frame_limit()
+    {
+        m_frameLimitIndex = (m_frameLimitIndex + 1) % std::size(FRAME_LIMITS);
+        m_nextFrameNs = 0;
+        m_stats.frameLimit = FRAME_LIMITS[m_frameLimitIndex];
+        std::cout << "Frame limit: " << (m_stats.frameLimit ? std::to_string(m_stats.frameLimit) + " fps" : "off") << std::endl;
+    }
+
+    void FramePacer::cycle_max_frames_in_flight()
+    {
+        m_maxFramesInFlight = m_maxFramesInFlight % MAX_FRAMES_IN_FLIGHT_LIMIT + 1;
+        m_stats.maxFramesInFlight = m_maxFramesInFlight;
+        std::cout << "Max frames in flight: " << m_maxFramesInFlight << std::endl;
+    }
+
+    void FramePacer::wait_for_frame(WGPUInstance instance)
+    {
+        // GPU backpressure first: input read after this wait is as fresh as it can be.
+        wgpuInstanceProcessEvents(instance);
+        while (m_framesInFlight >= m_maxFramesInFlight)
+        {
+            SDL_DelayNS(100000);
+            wgpuInstanceProcessEvents(instance);
+        }
+        m_stats.framesInFlight = m_framesInFlight;
+
+        uint32_t limit = FRAME_LIMITS[m_frameLimitIndex];
+        if (limit == 0)
+        {
+            return;
+        }
+
+        uint64_t period = NS_PER_SECOND / limit;
+        uint64_t now = SDL_GetTicksNS();
+        if (now < m_nextFrameNs)
+        {
+            SDL_DelayPrecise(m_nextFrameNs - now);
+            now = m_nextFrameNs;
+        }
+        // Keep a steady cadence, but don't try to catch up after a slow frame.
+        m_nextFrameNs = m_nextFrameNs + period > now ? m_nextFrameNs + period : now + period;
+    }
+
+    void FramePacer::on_input_event(const SDL_Event &event)
+    {
+        switch (event.type)
+        {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            // Event timestamps share SDL_GetTicksNS's clock.
+            if (m_oldestInputNs == 0 || event.common.timestamp < m_oldestInputNs)
+            {
+                m_oldestInputNs = event.common.timestamp;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void FramePacer::on_submit(WGPUQueue queue)
+    {
+        ++m_framesInFlight;
+
+        WGPUQueueWorkDoneCallbackInfo callbackInfo = {};
+        callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        callbackInfo.callback = on_submitted_work_done;
+        callbackInfo.userdata1 = this;
+        wgpuQueueOnSubmittedWorkDone(queue, callbackInfo);
+    }
+
+    void FramePacer::on_submitted_work_done(WGPUQueueWorkDoneStatus, void *userdata1, void *)
+    {
+        auto *pacer = static_cast<FramePacer *>(userdata1);
+        if (pacer->m_framesInFlight > 0)
+        {
+            --pacer->m_framesInFlight;
+        }
+    }
+
+    void FramePacer::on_present()
+    {
+        uint64_t now = SDL_GetTicksNS();
+
+        if (m_lastPresentNs != 0)
+        {
+            m_stats.frameMs = smooth(m_stats.frameMs, static_cast<double>(now - m_lastPresentNs) / 1e6);
+        }
+        m_lastPresentNs = now;
+
+        if (m_oldestInputNs != 0 && now > m_oldestInputNs)
+        {
+            double latencyMs = static_cast<double>(now - m_oldestInputNs) / 1e6;
+            m_stats.inputLatencyMs = smooth(m_stats.inputLatencyMs, latencyMs);
+            m_peakLatencyMs = std::max(m_peakLatencyMs, latencyMs);
+        }
+        m_oldestInputNs = 0;
+
+        // The peak covers the last full second, so one hitch doesn't stick forever.
+        if (now - m_peakWindowStartNs >= NS_PER_SECOND)
+        {
+            m_stats.inputLatencyPeakMs = m_peakLatencyMs;
+            m_peakLatencyMs = 0.0;
+            m_peakWindowStartNs = now;
+        }
+    }
+
+} // namespace flint
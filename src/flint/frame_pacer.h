@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/frame_stats.h"
+
+namespace flint
+{
+
+    // Trades throughput for responsiveness at runtime.
+    //
+    // Three knobs: the surface present mode (limited to what the surface
+    // supports), a CPU-side frame rate limit, and a cap on how many submitted
+    // frames the GPU may still be working on. Fewer queued frames and a limit
+    // just under the refresh rate both shorten the time between reading input
+    // and showing its result, which is measured from SDL event timestamps.
+    //
+    // Per frame: wait_for_frame before polling events, on_input_event for each
+    // event, on_submit after wgpuQueueSubmit and on_present after wgpuSurfacePresent.
+    class FramePacer
+    {
+    public:
+        void init(std::vector<WGPUPresentMode> supportedPresentModes);
+
+        WGPUPresentMode getPresentMode() const { return m_presentModes[m_presentModeIndex]; }
+
+        // Each of these steps to the next setting and wraps around. After
+        // cycling the present mode the caller must reconfigure the surface.
+        void cycle_present_mode();
+        void cycle_frame_limit();
+        void cycle_max_frames_in_flight();
+
+        // Blocks until fewer than the maximum frames are in flight and the frame limit allows a new frame.
+        void wait_for_frame(WGPUInstance instance);
+        void on_input_event(const SDL_Event &event);
+        void on_submit(WGPUQueue queue);
+        void on_present();
+
+        const graphics::FrameStats &getStats() const { return m_stats; }
+
+    private:
+        static void on_submitted_work_done(WGPUQueueWorkDoneStatus status, void *userdata1, void *userdata2);
+
+        std::vector<WGPUPresentMode> m_presentModes = {WGPUPresentMode_Fifo};
+        size_t m_presentModeIndex = 0;
+        size_t m_frameLimitIndex = 0;
+        uint32_t m_maxFramesInFlight = 3;
+
+        uint32_t m_framesInFlight = 0;
+        uint64_t m_nextFrameNs = 0;
+        uint64_t m_lastPresentNs = 0;
+        // Timestamp of the oldest input event not yet presented, 0 if none.
+        uint64_t m_oldestInputNs = 0;
+        uint64_t m_peakWindowStartNs = 0;
+        double m_peakLatencyMs = 0.0;
+
+        graphics::FrameStats m_stats;
+    };
+
+} // namespace flint
@@ -1,23 +1,28 @@
 #include "chunk_mesh.hpp"
 #include "../cube_geometry.h"
 #include "../vertex.h"
+#include "../world.h"
+#include "../init/gpu_memory.h"
+#include "../init/utils.h"
 #include <iostream>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 namespace
 {
-    // The texture atlas is a 16x1 grid of tiles.
-    const float ATLAS_COLS = 16.0f;
-    const float ATLAS_ROWS = 1.0f;
-
     struct FaceTextureInfo
     {
         std::array<glm::vec2, 4> uvs;
+        uint32_t layer;
         glm::vec3 color;
     };
 
-    // This function determines the texture coordinates and color for a given block face.
-    FaceTextureInfo get_face_texture_info(flint::BlockType block_type, flint::CubeGeometry::Face face)
+    // This function determines the texture layer, coordinates and color for a given block face.
+    // Layers follow the tile order of the block atlas strip. `scale` is the face's size in
+    // blocks; the coordinates run to `scale` so the texture repeats once per block.
+    FaceTextureInfo get_face_texture_info(flint::BlockType block_type, flint::CubeGeometry::Face face, int scale)
     {
         glm::ivec2 tile_coords;
 
@@ -61,20 +66,19 @@ namespace
             // the same way we do for grass.
             color = {0.1f, 0.9f, 0.1f};
             break;
+        case flint::BlockType::Glowstone:
+            tile_coords = {7, 0}; // Glowstone
+            break;
         default:
             tile_coords = {2, 0}; // Dirt
             break;
         }
 
-        // Calculate the size of a single texture tile in UV space.
-        float tile_width = 1.0f / ATLAS_COLS;
-        float tile_height = 1.0f / ATLAS_ROWS;
-
-        // Calculate UV coordinates from tile coordinates.
-        float u0 = static_cast<float>(tile_coords.x) * tile_width;
-        float v0 = static_cast<float>(tile_coords.y) * tile_height;
-        float u1 = u0 + tile_width;
-        float v1 = v0 + tile_height;
+        // Each tile is a whole layer, so coordinates cover the face rather than a slice of an atlas.
+        float u0 = 0.0f;
+        float v0 = 0.0f;
+        float u1 = static_cast<float>(scale);
+        float v1 = static_cast<float>(scale);
 
         std::array<glm::vec2, 4> uvs;
         switch (face)
@@ -100,7 +104,322 @@ namespace
             break;
         }
 
-        return {.uvs = uvs, .color = color};
+        return {.uvs = uvs, .layer = static_cast<uint32_t>(tile_coords.x), .color = color};
+    }
+
+    // A block of the cell grid, with the light per channel that faces looking into it receive.
+    struct Cell : flint::Block
+    {
+        using flint::Block::Block;
+
+        uint8_t sky_light = 0;
+        uint8_t block_light = 0;
+    };
+
+    // Collapses a `scale`^3 block cell of `chunk` into a single block.
+    // The cell is filled when at least half of its blocks are (majority selection)
+    // and takes the type of its top-most block, so surfaces keep their grass tops
+    // at a distance (top-surface selection). Its light, per channel, is the brightest
+    // light among its transparent blocks, which is what faces looking into the cell would see.
+    Cell downsample_cell(const flint::Chunk &chunk, int cell_x, int cell_y, int cell_z, int scale)
+    {
+        int filled = 0;
+        int top_y = -1;
+        flint::BlockType top_type = flint::BlockType::Air;
+        uint8_t light = 0;
+        uint8_t block_light = 0;
+
+        // Inside one section whose channels are each a single value, any transparent
+        // block gives the cell that light and none has to be looked up.
+        const size_t section = static_cast<size_t>(cell_y * scale) / flint::SECTION_HEIGHT;
+        const bool uniform_light = static_cast<size_t>((cell_y + 1) * scale - 1) / flint::SECTION_HEIGHT == section &&
+                                   chunk.sky_section(section).is_uniform() && chunk.block_section(section).is_uniform();
+        bool any_transparent = false;
+
+        for (int x = cell_x * scale; x < (cell_x + 1) * scale; ++x)
+        {
+            for (int y = cell_y * scale; y < (cell_y + 1) * scale; ++y)
+            {
+                for (int z = cell_z * scale; z < (cell_z + 1) * scale; ++z)
+                {
+                    const flint::Block *block = chunk.getBlock(x, y, z);
+                    if (block->type != flint::BlockType::Air)
+                    {
+                        ++filled;
+                        if (y > top_y)
+                        {
+                            top_y = y;
+                            top_type = block->type;
+                        }
+                    }
+                    if (block->isTransparent())
+                    {
+                        any_transparent = true;
+                        if (!uniform_light)
+                        {
+                            size_t index = flint::Chunk::block_index(x, y, z);
+                            light = std::max(light, chunk.sky_light(index));
+                            block_light = std::max(block_light, chunk.block_light(index));
+                        }
+                    }
+                }
+            }
+        }
+        if (uniform_light && any_transparent)
+        {
+            light = chunk.sky_section(section).uniform_light();
+            block_light = chunk.block_section(section).uniform_light();
+        }
+
+        Cell cell(filled * 2 >= scale * scale * scale ? top_type : flint::BlockType::Air);
+        cell.sky_light = light;
+        cell.block_light = block_light;
+        return cell;
+    }
+
+    // The cells of one chunk at one level of detail, padded by a single cell on
+    // every side. Padding cells only carry what the mesher needs from a neighbour:
+    // whether it hides a face (`isSolid`) and the light a visible face receives.
+    class CellGrid
+    {
+    public:
+        CellGrid(int size_x, int size_y, int size_z)
+            : size_x(size_x), size_y(size_y), size_z(size_z),
+              m_cells(static_cast<size_t>(size_x + 2) * (size_y + 2) * (size_z + 2), open_cell())
+        {
+        }
+
+        Cell &at(int x, int y, int z)
+        {
+            return m_cells[(static_cast<size_t>(x + 1) * (size_y + 2) + (y + 1)) * (size_z + 2) + (z + 1)];
+        }
+
+        const Cell &at(int x, int y, int z) const
+        {
+            return m_cells[(static_cast<size_t>(x + 1) * (size_y + 2) + (y + 1)) * (size_z + 2) + (z + 1)];
+        }
+
+        // What lies beyond the world or an unloaded chunk: open, fully lit air.
+        static Cell open_cell()
+        {
+            Cell cell(flint::BlockType::Air);
+            cell.sky_light = 15;
+            return cell;
+        }
+
+        const int size_x;
+        const int size_y;
+        const int size_z;
+
+    private:
+        std::vector<Cell> m_cells;
+    };
+
+    // Fills the padding layer on one horizontal side of `grid` (meshed at `scale`)
+    // from the neighbouring chunk, sampled at the scale that neighbour is meshed at.
+    // A padding cell only hides a face if everything the neighbour renders behind
+    // that face is solid. Both chunks of a mismatched border apply the same rule,
+    // so each side closes its own columns with a wall (a skirt) and no cracks open
+    // up between LOD levels.
+    void pad_border(CellGrid &grid, int scale, const flint::Chunk &neighbor, int neighbor_scale, int side)
+    {
+        using flint::CHUNK_DEPTH;
+        using flint::CHUNK_HEIGHT;
+        using flint::CHUNK_WIDTH;
+
+        const bool along_z = side < 2; // -X/+X borders run along Z, -Z/+Z borders along X.
+        const int border_cells = along_z ? grid.size_z : grid.size_x;
+        const int neighbor_border_cells = static_cast<int>(along_z ? CHUNK_DEPTH : CHUNK_WIDTH) / neighbor_scale;
+        const int neighbor_height_cells = static_cast<int>(CHUNK_HEIGHT) / neighbor_scale;
+
+        int neighbor_fixed = 0;
+        if (side == 0)
+            neighbor_fixed = static_cast<int>(CHUNK_WIDTH) / neighbor_scale - 1;
+        else if (side == 2)
+            neighbor_fixed = static_cast<int>(CHUNK_DEPTH) / neighbor_scale - 1;
+
+        // The neighbour's cells touching the border, at the neighbour's own scale.
+        std::vector<Cell> slice;
+        slice.reserve(static_cast<size_t>(neighbor_border_cells) * neighbor_height_cells);
+        for (int ny = 0; ny < neighbor_height_cells; ++ny)
+        {
+            for (int nu = 0; nu < neighbor_border_cells; ++nu)
+            {
+                slice.push_back(along_z ? downsample_cell(neighbor, neighbor_fixed, ny, nu, neighbor_scale)
+                                        : downsample_cell(neighbor, nu, ny, neighbor_fixed, neighbor_scale));
+            }
+        }
+
+        for (int y = 0; y < grid.size_y; ++y)
+        {
+            for (int u = 0; u < border_cells; ++u)
+            {
+                bool all_solid = true;
+                flint::BlockType solid_type = flint::BlockType::Air;
+                uint8_t light = 0;
+                uint8_t block_light = 0;
+
+                for (int ny = y * scale / neighbor_scale; ny <= (y * scale + scale - 1) / neighbor_scale; ++ny)
+                {
+                    for (int nu = u * scale / neighbor_scale; nu <= (u * scale + scale - 1) / neighbor_scale; ++nu)
+                    {
+                        const Cell &neighbor_cell = slice[static_cast<size_t>(ny) * neighbor_border_cells + nu];
+                        if (neighbor_cell.isSolid())
+                        {
+                            solid_type = neighbor_cell.type;
+                        }
+                        else
+                        {
+                            all_solid = false;
+                            light = std::max(light, neighbor_cell.sky_light);
+                            block_light = std::max(block_light, neighbor_cell.block_light);
+                        }
+                    }
+                }
+
+                Cell cell(all_solid ? solid_type : flint::BlockType::Air);
+                cell.sky_light = light;
+                cell.block_light = block_light;
+
+                switch (side)
+                {
+                case 0:
+                    grid.at(-1, y, u) = cell;
+                    break;
+                case 1:
+                    grid.at(grid.size_x, y, u) = cell;
+                    break;
+                case 2:
+                    grid.at(u, y, -1) = cell;
+                    break;
+                default:
+                    grid.at(u, y, grid.size_z) = cell;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Turns `chunk` into its grid of cells at `lod` (one block per cell at scale 1),
+    // padded from the loaded neighbours. Both the mesher and the light texture read it.
+    CellGrid build_cell_grid(const flint::World &world, const flint::Chunk &chunk, const flint::graphics::MeshLod &lod)
+    {
+        using flint::graphics::MeshLod;
+
+        const int scale = lod.scale;
+        CellGrid grid(static_cast<int>(flint::CHUNK_WIDTH) / scale, static_cast<int>(flint::CHUNK_HEIGHT) / scale, static_cast<int>(flint::CHUNK_DEPTH) / scale);
+
+        for (int x = 0; x < grid.size_x; ++x)
+        {
+            for (int y = 0; y < grid.size_y; ++y)
+            {
+                for (int z = 0; z < grid.size_z; ++z)
+                {
+                    grid.at(x, y, z) = downsample_cell(chunk, x, y, z, scale);
+                }
+            }
+        }
+
+        const int neighborChunkOffsets[MeshLod::NEIGHBOR_COUNT][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (int side = 0; side < MeshLod::NEIGHBOR_COUNT; ++side)
+        {
+            const flint::Chunk *neighbor = world.getChunk(chunk.getChunkX() + neighborChunkOffsets[side][0], chunk.getChunkZ() + neighborChunkOffsets[side][1]);
+            if (neighbor)
+            {
+                pad_border(grid, scale, *neighbor, lod.neighbor_scales[side], side);
+            }
+        }
+
+        return grid;
+    }
+
+    // The grid's light, padding included, laid out as a 3D texture (x fastest, then y, then z).
+    // Each texel holds sky light in its low nibble and block light in its high nibble.
+    uint8_t pack_light(const Cell &cell)
+    {
+        return static_cast<uint8_t>(cell.sky_light | cell.block_light << 4);
+    }
+
+    std::vector<uint8_t> light_texels(const CellGrid &grid)
+    {
+        const int width = grid.size_x + 2;
+        const int height = grid.size_y + 2;
+        const int depth = grid.size_z + 2;
+
+        std::vector<uint8_t> texels(static_cast<size_t>(width) * height * depth);
+        for (int z = 0; z < depth; ++z)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    texels[(static_cast<size_t>(z) * height + y) * width + x] = pack_light(grid.at(x - 1, y - 1, z - 1));
+                }
+            }
+        }
+        return texels;
+    }
+
+    // Grows the texel box `min`..`max` of a light texture at `lod` by the texels
+    // that blocks in `changed` feed: the chunk's cells holding them, and the
+    // padding cells sampled from a neighbour's cell holding them (the neighbour's
+    // cells are `scale` deep and wide, so one block can feed a run of padding texels).
+    void include_light_texels(const flint::Chunk &chunk, const flint::graphics::MeshLod &lod, const flint::BlockBox &changed, glm::ivec3 &min, glm::ivec3 &max)
+    {
+        using flint::BlockBox;
+        const glm::ivec3 extent(flint::CHUNK_WIDTH, flint::CHUNK_HEIGHT, flint::CHUNK_DEPTH);
+        const glm::ivec3 chunk_min(chunk.getChunkX() * extent.x, 0, chunk.getChunkZ() * extent.z);
+        const glm::ivec3 chunk_max = chunk_min + extent - glm::ivec3(1);
+
+        struct Part
+        {
+            BlockBox area;
+            int scale;
+        };
+        const std::array<int, 4> &n = lod.neighbor_scales;
+        const Part parts[] = {
+            {{chunk_min, chunk_max}, lod.scale},
+            {{{chunk_min.x - n[0], chunk_min.y, chunk_min.z}, {chunk_min.x - 1, chunk_max.y, chunk_max.z}}, n[0]},
+            {{{chunk_max.x + 1, chunk_min.y, chunk_min.z}, {chunk_max.x + n[1], chunk_max.y, chunk_max.z}}, n[1]},
+            {{{chunk_min.x, chunk_min.y, chunk_min.z - n[2]}, {chunk_max.x, chunk_max.y, chunk_min.z - 1}}, n[2]},
+            {{{chunk_min.x, chunk_min.y, chunk_max.z + 1}, {chunk_max.x, chunk_max.y, chunk_max.z + n[3]}}, n[3]},
+        };
+
+        // Below the chunk is the first padding texel, past it the last one.
+        auto texel_of = [&](const glm::ivec3 &block)
+        {
+            glm::ivec3 local = block - chunk_min;
+            glm::ivec3 texel;
+            for (int i = 0; i < 3; ++i)
+            {
+                texel[i] = local[i] < 0 ? 0 : (local[i] >= extent[i] ? extent[i] / lod.scale + 1 : local[i] / lod.scale + 1);
+            }
+            return texel;
+        };
+
+        for (const Part &part : parts)
+        {
+            glm::ivec3 lo = glm::max(changed.min, part.area.min);
+            glm::ivec3 hi = glm::min(changed.max, part.area.max);
+            if (lo.x > hi.x || lo.y > hi.y || lo.z > hi.z)
+            {
+                continue;
+            }
+            // Out to the whole cells of whichever chunk holds the blocks.
+            for (int i = 0; i < 3; ++i)
+            {
+                lo[i] = flint::World::floor_div(lo[i], part.scale) * part.scale;
+                hi[i] = flint::World::floor_div(hi[i], part.scale) * part.scale + part.scale - 1;
+            }
+            min = glm::min(min, texel_of(lo));
+            max = glm::max(max, texel_of(hi));
+        }
+    }
+
+    // Texel coordinates of grid cell (x, y, z) in the padded light texture.
+    uint32_t pack_light_cell(int x, int y, int z)
+    {
+        return static_cast<uint32_t>(x + 1) | static_cast<uint32_t>(y + 1) << 8 | static_cast<uint32_t>(z + 1) << 16;
     }
 } // namespace
 
@@ -117,39 +436,91 @@ namespace flint
         }
 
         void ChunkMesh::cleanup()
+        {
+            release_pending();
+            release_geometry();
+            release_light();
+        }
+
+        void ChunkMesh::release_pending()
+        {
+            if (m_uploadTicket != 0)
+            {
+                m_uploads->cancel(m_uploadTicket);
+                m_uploadTicket = 0;
+            }
+            if (m_pendingVertexBuffer)
+            {
+                wgpuBufferDestroy(m_pendingVertexBuffer);
+                init::release_buffer(m_pendingVertexBuffer, init::GpuMemoryKind::ChunkGeometry);
+            }
+            if (m_pendingIndexBuffer)
+            {
+                wgpuBufferDestroy(m_pendingIndexBuffer);
+                init::release_buffer(m_pendingIndexBuffer, init::GpuMemoryKind::ChunkGeometry);
+            }
+            m_pendingIndexCount = 0;
+            m_pendingLight.clear();
+        }
+
+        void ChunkMesh::apply_pending()
+        {
+            // The upload is recorded, so the old geometry can go and the new one takes its place.
+            m_uploadTicket = 0;
+            release_geometry();
+            m_vertexBuffer = m_pendingVertexBuffer;
+            m_indexBuffer = m_pendingIndexBuffer;
+            m_indexCount = m_pendingIndexCount;
+            m_lod = m_pendingLod;
+            m_pendingVertexBuffer = nullptr;
+            m_pendingIndexBuffer = nullptr;
+            m_pendingIndexCount = 0;
+
+            upload_light(m_pendingLight, m_pendingLightSize.width, m_pendingLightSize.height, m_pendingLightSize.depthOrArrayLayers);
+            m_pendingLight.clear();
+        }
+
+        void ChunkMesh::release_geometry()
         {
             if (m_vertexBuffer)
             {
                 wgpuBufferDestroy(m_vertexBuffer);
-                wgpuBufferRelease(m_vertexBuffer);
-                m_vertexBuffer = nullptr;
+                init::release_buffer(m_vertexBuffer, init::GpuMemoryKind::ChunkGeometry);
             }
             if (m_indexBuffer)
             {
                 wgpuBufferDestroy(m_indexBuffer);
-                wgpuBufferRelease(m_indexBuffer);
-                m_indexBuffer = nullptr;
+                init::release_buffer(m_indexBuffer, init::GpuMemoryKind::ChunkGeometry);
             }
             m_indexCount = 0;
         }
 
-        void ChunkMesh::generate(WGPUDevice device, const flint::Chunk &chunk)
+        void ChunkMesh::generate(WGPUDevice device, const flint::World &world, const flint::Chunk &chunk, const MeshLod &lod, WGPUBindGroupLayout lightLayout,
+                                 UploadScheduler &uploads, std::function<void()> onUploaded)
         {
             m_device = device;
-            cleanup(); // Clean up existing buffers before generating new ones.
+            m_lightLayout = lightLayout;
+            m_uploads = &uploads;
+            release_pending(); // A newer mesh supersedes one that is still queued.
+
+            // Full-detail and LOD meshes go through the same path: the chunk is first
+            // turned into a grid of cells, then every cell face that is not hidden by
+            // a solid neighbour cell is emitted.
+            const int scale = lod.scale;
+            const CellGrid grid = build_cell_grid(world, chunk, lod);
 
             std::vector<flint::Vertex> vertices;
             std::vector<uint16_t> indices;
             uint16_t currentIndex = 0;
 
-            for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+            for (int x = 0; x < grid.size_x; ++x)
             {
-                for (size_t y = 0; y < CHUNK_HEIGHT; ++y)
+                for (int y = 0; y < grid.size_y; ++y)
                 {
-                    for (size_t z = 0; z < CHUNK_DEPTH; ++z)
+                    for (int z = 0; z < grid.size_z; ++z)
                     {
-                        const Block *currentBlock = chunk.getBlock(x, y, z);
-                        if (!currentBlock || currentBlock->type == BlockType::Air)
+                        const Block &currentBlock = grid.at(x, y, z);
+                        if (currentBlock.type == BlockType::Air)
                         {
                             continue;
                         }
@@ -169,40 +540,31 @@ namespace flint
 
                         for (size_t i = 0; i < faces.size(); ++i)
                         {
-                            int nx = x + neighborOffsets[i][0];
-                            int ny = y + neighborOffsets[i][1];
-                            int nz = z + neighborOffsets[i][2];
-
-                            const Block *neighborBlock = chunk.getBlock(nx, ny, nz);
+                            const int nx = x + neighborOffsets[i][0];
+                            const int ny = y + neighborOffsets[i][1];
+                            const int nz = z + neighborOffsets[i][2];
+                            const Block &neighborBlock = grid.at(nx, ny, nz);
 
-                            if (!neighborBlock || !neighborBlock->isSolid())
+                            if (!neighborBlock.isSolid())
                             {
                                 // This face is visible, add it to the mesh.
-                                auto face_info = get_face_texture_info(currentBlock->type, faces[i]);
+                                auto face_info = get_face_texture_info(currentBlock.type, faces[i], scale);
                                 std::vector<flint::Vertex> faceVertices = CubeGeometry::getFaceVertices(faces[i]);
                                 const std::vector<uint16_t> &faceIndices = CubeGeometry::getLocalFaceIndices();
 
                                 for (size_t j = 0; j < faceVertices.size(); ++j)
                                 {
-                                    float sky_light = 0.0f;
-                                    if (neighborBlock)
-                                    {
-                                        sky_light = (float)neighborBlock->sky_light;
-                                    }
-                                    else
-                                    {
-                                        // If there is no neighbor, it's a chunk boundary
-                                        sky_light = 15.0f;
-                                    }
-
                                     vertices.push_back({
-                                        // Offset the vertex position by the block's position in the chunk.
-                                        .position = faceVertices[j].position + glm::vec3(x, y, z),
+                                        // Scale the unit cube to the cell size and offset it by the cell's position in the chunk.
+                                        // The chunk's world origin is applied in the vertex shader.
+                                        .position = (faceVertices[j].position + glm::vec3(x, y, z)) * static_cast<float>(scale),
                                         // The color is now used for lighting/tinting.
                                         .color = face_info.color,
                                         // Assign the UV coordinates for this vertex.
                                         .uv = face_info.uvs[j],
-                                        .sky_light = sky_light,
+                                        // The face is lit by the cell it looks into.
+                                        .light_cell = pack_light_cell(nx, ny, nz),
+                                        .texture_layer = face_info.layer,
                                     });
                                 }
 
@@ -219,39 +581,192 @@ namespace flint
 
             if (vertices.empty() || indices.empty())
             {
-                std::cout << "Chunk mesh is empty, nothing to render." << std::endl;
+                release_geometry();
+                release_light();
+                m_lod = lod;
                 return;
             }
 
-            // Create vertex buffer
+            // The buffers stay unused until the scheduler has recorded their copy.
             WGPUBufferDescriptor vertexBufferDesc = {};
             vertexBufferDesc.size = vertices.size() * sizeof(flint::Vertex);
             vertexBufferDesc.usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst;
             vertexBufferDesc.mappedAtCreation = false;
-            m_vertexBuffer = wgpuDeviceCreateBuffer(m_device, &vertexBufferDesc);
-            wgpuQueueWriteBuffer(wgpuDeviceGetQueue(m_device), m_vertexBuffer, 0, vertices.data(), vertexBufferDesc.size);
+            m_pendingVertexBuffer = wgpuDeviceCreateBuffer(m_device, &vertexBufferDesc);
 
-            // Create index buffer
             WGPUBufferDescriptor indexBufferDesc = {};
             indexBufferDesc.size = indices.size() * sizeof(uint16_t);
             indexBufferDesc.usage = WGPUBufferUsage_Index | WGPUBufferUsage_CopyDst;
             indexBufferDesc.mappedAtCreation = false;
-            m_indexBuffer = wgpuDeviceCreateBuffer(m_device, &indexBufferDesc);
-            wgpuQueueWriteBuffer(wgpuDeviceGetQueue(m_device), m_indexBuffer, 0, indices.data(), indexBufferDesc.size);
+            m_pendingIndexBuffer = wgpuDeviceCreateBuffer(m_device, &indexBufferDesc);
+            init::track_gpu_allocation(init::GpuMemoryKind::ChunkGeometry, vertexBufferDesc.size + indexBufferDesc.size);
+
+            m_pendingIndexCount = indices.size();
+            m_pendingLod = lod;
+            m_pendingLight = light_texels(grid);
+            m_pendingLightSize = {static_cast<uint32_t>(grid.size_x + 2), static_cast<uint32_t>(grid.size_y + 2), static_cast<uint32_t>(grid.size_z + 2)};
+
+            // Six indices per face keep the index data a multiple of 4 bytes, as copies require.
+            std::vector<UploadScheduler::BufferWrite> writes(2);
+            writes[0].destination = m_pendingVertexBuffer;
+            writes[0].data.resize(vertexBufferDesc.size);
+            std::memcpy(writes[0].data.data(), vertices.data(), vertexBufferDesc.size);
+            writes[1].destination = m_pendingIndexBuffer;
+            writes[1].data.resize(indexBufferDesc.size);
+            std::memcpy(writes[1].data.data(), indices.data(), indexBufferDesc.size);
 
-            m_indexCount = indices.size();
+            glm::vec3 center(
+                (static_cast<float>(chunk.getChunkX()) + 0.5f) * CHUNK_WIDTH,
+                CHUNK_HEIGHT * 0.5f,
+                (static_cast<float>(chunk.getChunkZ()) + 0.5f) * CHUNK_DEPTH);
+            m_uploadTicket = uploads.enqueue(std::move(writes), center, [this, onUploaded = std::move(onUploaded)]()
+                                             {
+                                                 apply_pending();
+                                                 if (onUploaded)
+                                                 {
+                                                     onUploaded();
+                                                 }
+                                             });
+        }
+
+        void ChunkMesh::update_light(const flint::World &world, const flint::Chunk &chunk, const std::vector<BlockBox> &changed)
+        {
+            if (isUploadPending())
+            {
+                m_pendingLight = light_texels(build_cell_grid(world, chunk, m_pendingLod));
+            }
+
+            if (isEmpty())
+            {
+                return; // No faces, nothing samples the light.
+            }
+
+            glm::ivec3 min(std::numeric_limits<int>::max());
+            glm::ivec3 max(std::numeric_limits<int>::min());
+            for (const BlockBox &box : changed)
+            {
+                include_light_texels(chunk, m_lod, box, min, max);
+            }
+            if (min.x > max.x)
+            {
+                return; // The changes are in the neighbours, away from this chunk's border.
+            }
+
+            const CellGrid grid = build_cell_grid(world, chunk, m_lod);
+            const uint32_t width = grid.size_x + 2;
+            const uint32_t height = grid.size_y + 2;
+            const uint32_t depth = grid.size_z + 2;
+            if (!m_lightTexture || m_lightSize.width != width || m_lightSize.height != height || m_lightSize.depthOrArrayLayers != depth)
+            {
+                upload_light(light_texels(grid), width, height, depth);
+                return;
+            }
+            upload_light_region(light_texels(grid), min, max);
+        }
+
+        void ChunkMesh::upload_light(const std::vector<uint8_t> &texels, uint32_t width, uint32_t height, uint32_t depth)
+        {
+            // The size only changes with the level of detail, otherwise the texture is rewritten in place.
+            if (!m_lightTexture || m_lightSize.width != width || m_lightSize.height != height || m_lightSize.depthOrArrayLayers != depth)
+            {
+                release_light();
+                m_lightSize = {width, height, depth};
+
+                WGPUTextureDescriptor textureDesc = {};
+                textureDesc.label = init::makeStringView("Chunk Light Texture");
+                textureDesc.dimension = WGPUTextureDimension_3D;
+                textureDesc.format = WGPUTextureFormat_R8Uint;
+                textureDesc.mipLevelCount = 1;
+                textureDesc.sampleCount = 1;
+                textureDesc.size = m_lightSize;
+                textureDesc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+                m_lightTexture = wgpuDeviceCreateTexture(m_device, &textureDesc);
+                init::track_gpu_allocation(init::GpuMemoryKind::ChunkLight, init::texture_size_bytes(m_lightTexture));
+                m_lightView = wgpuTextureCreateView(m_lightTexture, nullptr);
+
+                WGPUBindGroupEntry lightBinding = {};
+                lightBinding.binding = 0;
+                lightBinding.textureView = m_lightView;
+
+                WGPUBindGroupDescriptor bindGroupDesc = {};
+                bindGroupDesc.layout = m_lightLayout;
+                bindGroupDesc.entryCount = 1;
+                bindGroupDesc.entries = &lightBinding;
+                m_lightBindGroup = wgpuDeviceCreateBindGroup(m_device, &bindGroupDesc);
+            }
+
+            WGPUTexelCopyTextureInfo destination = {};
+            destination.texture = m_lightTexture;
+            destination.mipLevel = 0;
+            destination.origin = {0, 0, 0};
+            destination.aspect = WGPUTextureAspect_All;
+
+            WGPUTexelCopyBufferLayout dataLayout = {};
+            dataLayout.offset = 0;
+            dataLayout.bytesPerRow = width;
+            dataLayout.rowsPerImage = height;
+
+            wgpuQueueWriteTexture(wgpuDeviceGetQueue(m_device), &destination, texels.data(), texels.size(), &dataLayout, &m_lightSize);
+        }
+
+        void ChunkMesh::upload_light_region(const std::vector<uint8_t> &texels, const glm::ivec3 &min, const glm::ivec3 &max)
+        {
+            const glm::ivec3 size = max - min + glm::ivec3(1);
+            std::vector<uint8_t> region(static_cast<size_t>(size.x) * size.y * size.z);
+            for (int z = 0; z < size.z; ++z)
+            {
+                for (int y = 0; y < size.y; ++y)
+                {
+                    const size_t from = ((static_cast<size_t>(min.z + z) * m_lightSize.height) + min.y + y) * m_lightSize.width + min.x;
+                    std::memcpy(region.data() + (static_cast<size_t>(z) * size.y + y) * size.x, texels.data() + from, size.x);
+                }
+            }
+
+            WGPUTexelCopyTextureInfo destination = {};
+            destination.texture = m_lightTexture;
+            destination.mipLevel = 0;
+            destination.origin = {static_cast<uint32_t>(min.x), static_cast<uint32_t>(min.y), static_cast<uint32_t>(min.z)};
+            destination.aspect = WGPUTextureAspect_All;
+
+            WGPUTexelCopyBufferLayout dataLayout = {};
+            dataLayout.offset = 0;
+            dataLayout.bytesPerRow = static_cast<uint32_t>(size.x);
+            dataLayout.rowsPerImage = static_cast<uint32_t>(size.y);
+
+            WGPUExtent3D extent = {static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), static_cast<uint32_t>(size.z)};
+            wgpuQueueWriteTexture(wgpuDeviceGetQueue(m_device), &destination, region.data(), region.size(), &dataLayout, &extent);
+        }
+
+        void ChunkMesh::release_light()
+        {
+            if (m_lightBindGroup)
+            {
+                wgpuBindGroupRelease(m_lightBindGroup);
+                m_lightBindGroup = nullptr;
+            }
+            if (m_lightView)
+            {
+                wgpuTextureViewRelease(m_lightView);
+                m_lightView = nullptr;
+            }
+            if (m_lightTexture)
+            {
+                wgpuTextureDestroy(m_lightTexture);
+                init::release_texture(m_lightTexture, init::GpuMemoryKind::ChunkLight);
+            }
+            m_lightSize = {0, 0, 0};
         }
 
-        void ChunkMesh::render(WGPURenderPassEncoder renderPass) const
+        void ChunkMesh::record(WGPURenderBundleEncoder bundleEncoder) const
         {
             if (!m_vertexBuffer || !m_indexBuffer || m_indexCount == 0)
             {
                 return; // Nothing to render
             }
 
-            wgpuRenderPassEncoderSetVertexBuffer(renderPass, 0, m_vertexBuffer, 0, WGPU_WHOLE_SIZE);
-            wgpuRenderPassEncoderSetIndexBuffer(renderPass, m_indexBuffer, WGPUIndexFormat_Uint16, 0, WGPU_WHOLE_SIZE);
-            wgpuRenderPassEncoderDrawIndexed(renderPass, m_indexCount, 1, 0, 0, 0);
+            wgpuRenderBundleEncoderSetVertexBuffer(bundleEncoder, 0, m_vertexBuffer, 0, WGPU_WHOLE_SIZE);
+            wgpuRenderBundleEncoderSetIndexBuffer(bundleEncoder, m_indexBuffer, WGPUIndexFormat_Uint16, 0, WGPU_WHOLE_SIZE);
+            wgpuRenderBundleEncoderDrawIndexed(bundleEncoder, m_indexCount, 1, 0, 0, 0);
         }
 
     } // namespace graphics
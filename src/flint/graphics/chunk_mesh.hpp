@@ -2,29 +2,102 @@
 
 #include "webgpu/webgpu.h"
 #include "../chunk.h"
+#include "upload_scheduler.h"
+#include <array>
+#include <functional>
 #include <vector>
 
 namespace flint
 {
+    class World;
+
     namespace graphics
     {
+        // Level of detail a chunk mesh is built at. `scale` is the edge length,
+        // in blocks, of one meshed cell: 1 for full detail, 2/4/8 for meshes
+        // built from a downsampled voxel grid. The neighbour scales decide how
+        // the chunk's border faces are culled, so LOD transitions stay watertight.
+        struct MeshLod
+        {
+            // Order of the horizontal neighbours: -X, +X, -Z, +Z.
+            static constexpr int NEIGHBOR_COUNT = 4;
+
+            int scale = 1;
+            std::array<int, NEIGHBOR_COUNT> neighbor_scales = {1, 1, 1, 1};
+
+            bool operator==(const MeshLod &other) const = default;
+        };
+
+        // The geometry of one chunk plus its light, kept apart so light changes
+        // don't need a remesh.
+        //
+        // Light lives in a small 3D texture with one texel per mesh cell and a
+        // one-cell border taken from the neighbours (the same padded grid the
+        // mesher culls against). Each vertex stores which texel its face looks
+        // into, and the fragment shader loads the light from there.
+        // `update_light` rewrites only the texture.
+        //
+        // New geometry goes to the GPU through the upload scheduler. Until it
+        // arrives the previous buffers and light texture keep being drawn, so a
+        // rebuilt chunk never blinks out; both are swapped together once the
+        // copy is recorded.
         class ChunkMesh
         {
         public:
             ChunkMesh();
             ~ChunkMesh();
 
-            void generate(WGPUDevice device, const flint::Chunk &chunk);
-            void render(WGPURenderPassEncoder renderPass) const;
+            // `lightLayout` is the layout of the per-chunk light bind group (a texture_3d<u32>).
+            // `onUploaded` runs when the new geometry replaces the old one; an empty
+            // mesh replaces it right away, without a callback.
+            void generate(WGPUDevice device, const flint::World &world, const flint::Chunk &chunk, const MeshLod &lod, WGPUBindGroupLayout lightLayout,
+                          UploadScheduler &uploads, std::function<void()> onUploaded);
+            // Re-uploads the part of the light texture that `changed` (world
+            // coordinates, in this chunk or its neighbours) feeds at the mesh's
+            // current level of detail, and refreshes the light waiting with a
+            // queued upload.
+            void update_light(const flint::World &world, const flint::Chunk &chunk, const std::vector<BlockBox> &changed);
+            void record(WGPURenderBundleEncoder bundleEncoder) const;
             void cleanup();
 
+            bool isEmpty() const { return m_indexCount == 0; }
+            bool isUploadPending() const { return m_uploadTicket != 0; }
+
+            // The chunk's light bind group, bound at group 2 by the world renderer.
+            WGPUBindGroup getLightBindGroup() const { return m_lightBindGroup; }
+
         private:
+            void upload_light(const std::vector<uint8_t> &texels, uint32_t width, uint32_t height, uint32_t depth);
+            // Rewrites the texels from `min` to `max` (inclusive) of the existing texture from `texels`, laid out as for upload_light.
+            void upload_light_region(const std::vector<uint8_t> &texels, const glm::ivec3 &min, const glm::ivec3 &max);
+            void release_geometry();
+            void release_light();
+            void apply_pending();
+            void release_pending();
+
             // GPU buffers
             WGPUBuffer m_vertexBuffer = nullptr;
             WGPUBuffer m_indexBuffer = nullptr;
             WGPUDevice m_device = nullptr;
 
             uint32_t m_indexCount = 0;
+            MeshLod m_lod;
+
+            WGPUBindGroupLayout m_lightLayout = nullptr;
+            WGPUTexture m_lightTexture = nullptr;
+            WGPUTextureView m_lightView = nullptr;
+            WGPUBindGroup m_lightBindGroup = nullptr;
+            WGPUExtent3D m_lightSize = {0, 0, 0};
+
+            // Geometry and light waiting for their upload to be recorded.
+            UploadScheduler *m_uploads = nullptr;
+            uint64_t m_uploadTicket = 0;
+            WGPUBuffer m_pendingVertexBuffer = nullptr;
+            WGPUBuffer m_pendingIndexBuffer = nullptr;
+            uint32_t m_pendingIndexCount = 0;
+            MeshLod m_pendingLod;
+            std::vector<uint8_t> m_pendingLight;
+            WGPUExtent3D m_pendingLightSize = {0, 0, 0};
         };
     } // namespace graphics
-} // namespace flint
\ No newline at end of file
+} // namespace flint
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "../init/buffer.h"
+#include "../init/gpu_memory.h"
 
 namespace flint::graphics
 {
@@ -55,20 +56,12 @@ void CrosshairMesh::generate(WGPUDevice device, int width, int height)
 
     void CrosshairMesh::cleanup()
     {
-        if (m_vertexBuffer)
-        {
-            wgpuBufferRelease(m_vertexBuffer);
-            m_vertexBuffer = nullptr;
-        }
+        init::release_buffer(m_vertexBuffer);
         m_vertexCount = 0;
     }
 
     void CrosshairMesh::onResize(int width, int height) {
-        if (m_vertexBuffer)
-        {
-            wgpuBufferRelease(m_vertexBuffer);
-            m_vertexBuffer = nullptr;
-        }
+        init::release_buffer(m_vertexBuffer);
 
         const float crosshair_len_px = 40.0f;
         const float crosshair_thickness_px = 4.0f;
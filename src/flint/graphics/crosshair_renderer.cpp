@@ -14,7 +14,7 @@ namespace flint::graphics
 
     CrosshairRenderer::~CrosshairRenderer() = default;
 
-    void CrosshairRenderer::init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, int width, int height)
+    void CrosshairRenderer::init(WGPUDevice device, WGPUTextureFormat surfaceFormat, int width, int height)
     {
         std::cout << "Initializing crosshair renderer..." << std::endl;
 
@@ -87,7 +87,7 @@ namespace flint::graphics
 
             pipelineDescriptor.layout = pipelineLayout;
 
-            m_renderPipeline.pipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDescriptor);
+            m_renderPipeline.createAsync(device, pipelineDescriptor);
 
             wgpuPipelineLayoutRelease(pipelineLayout);
         }
@@ -113,6 +113,11 @@ namespace flint::graphics
         m_crosshairMesh.onResize(width, height);
     }
 
+    bool CrosshairRenderer::isReady() const
+    {
+        return m_renderPipeline.isReady();
+    }
+
     void CrosshairRenderer::cleanup()
     {
         std::cout << "Cleaning up crosshair renderer..." << std::endl;
@@ -14,9 +14,11 @@ namespace flint::graphics
         CrosshairRenderer();
         ~CrosshairRenderer();
 
-        void init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, int width, int height);
+        void init(WGPUDevice device, WGPUTextureFormat surfaceFormat, int width, int height);
         void render(WGPURenderPassEncoder renderPass);
         void cleanup();
+
+        bool isReady() const;
         void onResize(int width, int height);
 
     private:
@@ -14,6 +14,10 @@
 
 namespace flint::graphics
 {
+    namespace
+    {
+        constexpr double MIB = 1024.0 * 1024.0;
+    }
 
     DebugScreenRenderer::DebugScreenRenderer() = default;
 
@@ -47,7 +51,7 @@ namespace flint::graphics
         std::cout << "Debug screen renderer initialized." << std::endl;
     }
 
-    void DebugScreenRenderer::render_ui(const flint::player::Player &player, const flint::World &world)
+    void DebugScreenRenderer::render_ui(const flint::player::Player &player, const flint::World &world, const FrameStats &frameStats)
     {
         // Create a simple text overlay (like Minecraft HUD)
         // Position in top-left corner with no window decorations
@@ -93,13 +97,48 @@ namespace flint::graphics
         const Block *feet_block = world.getBlock(block_pos.x, block_pos.y, block_pos.z);
         if (feet_block)
         {
-            ImGui::Text("Light: %d", feet_block->sky_light);
+            ImGui::Text("Light: sky %d, block %d", world.sky_light(block_pos.x, block_pos.y, block_pos.z), world.block_light(block_pos.x, block_pos.y, block_pos.z));
         }
         else
         {
             ImGui::Text("Light: N/A");
         }
 
+        // Day/night (F8 cycles normal speed, fast-forward, paused)
+        int minutesOfDay = static_cast<int>(frameStats.timeOfDay * 24.0f * 60.0f);
+        ImGui::Text("Time: %02d:%02d  Sky: %.0f%%  Speed: %.0fx", minutesOfDay / 60, minutesOfDay % 60, frameStats.skyBrightness * 100.0f, frameStats.daySpeed);
+
+        // Frame pacing (F4 present mode, F5 frame limit, F6 frames in flight)
+        ImGui::Separator();
+        ImGui::Text("Frame: %.2f ms (%.0f fps)", frameStats.frameMs, frameStats.frameMs > 0.0 ? 1000.0 / frameStats.frameMs : 0.0);
+        ImGui::Text("Present: %s  Limit: %s", frameStats.presentMode, frameStats.frameLimit ? std::to_string(frameStats.frameLimit).c_str() : "off");
+        ImGui::Text("In flight: %u / %u", frameStats.framesInFlight, frameStats.maxFramesInFlight);
+        ImGui::Text("Input latency: %.1f ms (peak %.1f ms)", frameStats.inputLatencyMs, frameStats.inputLatencyPeakMs);
+        ImGui::Text("Terrain draws: %zu (sorted in %.3f ms)", frameStats.terrainDraws, frameStats.drawSortMs);
+        ImGui::Text("Uploads: %zu queued (%.1f KiB), %.1f KiB last frame", frameStats.uploadQueueDepth, frameStats.uploadQueuedBytes / 1024.0, frameStats.uploadBytes / 1024.0);
+        ImGui::Text("GPU memory: %.1f MiB, chunks %.1f / %.0f MiB", frameStats.gpuMemoryBytes / MIB, frameStats.chunkMeshBytes / MIB, frameStats.chunkMeshBudget / MIB);
+        ImGui::Text("Mesh distance: %d / %d", frameStats.meshDistance, frameStats.viewDistance);
+        // Dynamic resolution scales by GPU pass time, so it idles without timestamp queries.
+        const char *dynamic = !frameStats.dynamicResolution ? "off" : frameStats.gpuTimestamps ? "on" : "unavailable, no GPU timestamps";
+        ImGui::Text("Render: %ux%u (%.0f%%, dynamic %s, F7)", frameStats.renderWidth, frameStats.renderHeight, frameStats.renderScale * 100.0f, dynamic);
+
+        // GPU time per pass
+        ImGui::Separator();
+        if (frameStats.gpuTimestamps)
+        {
+            double total = 0.0;
+            for (const GpuPassTime &pass : frameStats.gpuPasses)
+            {
+                ImGui::Text("GPU %s: %.3f ms", pass.name, pass.ms);
+                total += pass.ms;
+            }
+            ImGui::Text("GPU total: %.3f ms", total);
+        }
+        else
+        {
+            ImGui::Text("GPU: timestamp queries unavailable");
+        }
+
         ImGui::End();
     }
 
@@ -3,6 +3,8 @@
 #include <SDL3/SDL.h>
 #include <webgpu/webgpu.h>
 
+#include "frame_stats.h"
+
 namespace flint
 {
     class World;
@@ -25,7 +27,7 @@ namespace flint::graphics
         void cleanup();
 
         // Creates ImGui windows (does NOT manage frame lifecycle)
-        void render_ui(const flint::player::Player &player, const flint::World &world);
+        void render_ui(const flint::player::Player &player, const flint::World &world, const FrameStats &frameStats);
 
     private:
         SDL_Window *m_window = nullptr;
@@ -0,0 +1,51 @@
+#include "draw_order.h"
+
+#include <array>
+#include <bit>
+
+namespace flint::graphics
+{
+
+    void DrawOrder::add(float distanceSquared, uint32_t index)
+    {
+        // -0.0 and NaN would break the unsigned ordering; neither is a useful distance.
+        float distance = distanceSquared > 0.0f ? distanceSquared : 0.0f;
+        m_items.push_back({std::bit_cast<uint32_t>(distance), index});
+    }
+
+    void DrawOrder::sort()
+    {
+        if (m_items.size() < 2)
+        {
+            return;
+        }
+
+        m_scratch.resize(m_items.size());
+        for (uint32_t shift = 0; shift < 32; shift += 8)
+        {
+            std::array<uint32_t, 256> counts = {};
+            for (const Item &item : m_items)
+            {
+                ++counts[(item.key >> shift) & 0xff];
+            }
+            if (counts[(m_items[0].key >> shift) & 0xff] == m_items.size())
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t &count : counts)
+            {
+                uint32_t bucketSize = count;
+                count = offset;
+                offset += bucketSize;
+            }
+            for (const Item &item : m_items)
+            {
+                m_scratch[counts[(item.key >> shift) & 0xff]++] = item;
+            }
+            m_items.swap(m_scratch);
+        }
+    }
+
+} // namespace flint::graphics
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace flint::graphics
+{
+    // Sorts draws by their squared distance to the camera, once per frame.
+    //
+    // Opaque geometry is drawn nearest first, so early depth testing rejects
+    // most hidden fragments. Translucent geometry needs the opposite order for
+    // blending and walks the same result from the back.
+    //
+    // Squared distances are non-negative floats, whose bit patterns compare
+    // like unsigned integers, so the sort is an LSD radix sort on those bits:
+    // linear in the number of draws, with no comparisons. Passes where every
+    // key has the same byte are skipped, which is usually the top one.
+    class DrawOrder
+    {
+    public:
+        struct Item
+        {
+            uint32_t key;
+            // Caller's index of the draw.
+            uint32_t index;
+        };
+
+        void clear() { m_items.clear(); }
+        void add(float distanceSquared, uint32_t index);
+        void sort();
+
+        // Nearest first after `sort`; iterate in reverse for back-to-front.
+        const std::vector<Item> &getItems() const { return m_items; }
+
+    private:
+        std::vector<Item> m_items;
+        std::vector<Item> m_scratch;
+    };
+
+} // namespace flint::graphics
@@ -0,0 +1,77 @@
+#include "dynamic_resolution.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace flint::graphics
+{
+    namespace
+    {
+        constexpr uint32_t FRAMES_PER_DECISION = 30;
+        constexpr float SCALE_STEP = 0.05f;
+        // Share of the budget the measured cost may use; the rest is left for
+        // the CPU side and for spikes.
+        constexpr double TARGET_LOAD = 0.85;
+        // Below this share of the budget the scale is raised again.
+        constexpr double RAISE_LOAD = 0.6;
+
+        float quantize(float scale)
+        {
+            return std::clamp(std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP, DynamicResolution::MIN_SCALE, DynamicResolution::MAX_SCALE);
+        }
+    }
+
+    void DynamicResolution::update(const FrameStats &stats)
+    {
+        m_available = stats.gpuTimestamps;
+        if (!isActive() || ++m_framesSinceDecision < FRAMES_PER_DECISION)
+        {
+            return;
+        }
+        m_framesSinceDecision = 0;
+
+        double costMs = 0.0;
+        for (const GpuPassTime &pass : stats.gpuPasses)
+        {
+            costMs += pass.ms;
+        }
+        if (costMs <= 0.0)
+        {
+            return;
+        }
+
+        double budgetMs = 1000.0 / (stats.frameLimit ? stats.frameLimit : 60);
+        double load = costMs / (budgetMs * TARGET_LOAD);
+
+        float scale = m_scale;
+        if (load > 1.0)
+        {
+            // Cost scales with the pixel count, i.e. with scale squared.
+            scale = std::min(quantize(m_scale / static_cast<float>(std::sqrt(load))), m_scale - SCALE_STEP);
+        }
+        else if (load < RAISE_LOAD)
+        {
+            scale = m_scale + SCALE_STEP;
+        }
+
+        scale = std::clamp(quantize(scale), MIN_SCALE, MAX_SCALE);
+        if (scale != m_scale)
+        {
+            m_scale = scale;
+            std::cout << "Render scale: " << static_cast<int>(std::round(m_scale * 100.0f)) << "%" << std::endl;
+        }
+    }
+
+    void DynamicResolution::toggle()
+    {
+        m_enabled = !m_enabled;
+        m_framesSinceDecision = 0;
+        if (!m_enabled)
+        {
+            m_scale = MAX_SCALE;
+        }
+        std::cout << "Dynamic resolution: " << (m_enabled ? "on" : "off") << std::endl;
+    }
+
+} // namespace flint::graphics
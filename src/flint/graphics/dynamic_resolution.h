@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "frame_stats.h"
+
+namespace flint::graphics
+{
+
+    // Picks the render scale of the world pass from measured frame cost.
+    //
+    // The cost is the summed GPU pass time from timestamp queries. It is
+    // compared against the frame budget (the frame limit, or 60 fps when
+    // uncapped). Over budget, the scale drops in one step by roughly the
+    // factor that would fit, since cost grows with pixel count. With plenty of
+    // headroom it creeps back up in small steps.
+    //
+    // Decisions are made every few dozen frames on quantized scales, so the
+    // offscreen targets only change size occasionally and can be pooled.
+    //
+    // Without timestamp queries there is no measure of GPU work: the frame time
+    // includes the vsync wait and the frame limiter's sleep, so it always looks
+    // at or over budget. The world pass then stays at full resolution.
+    class DynamicResolution
+    {
+    public:
+        static constexpr float MIN_SCALE = 0.5f;
+        static constexpr float MAX_SCALE = 1.0f;
+
+        void update(const FrameStats &stats);
+
+        bool isEnabled() const { return m_enabled; }
+        // Enabled, and the adapter reports GPU pass times to scale by.
+        bool isActive() const { return m_enabled && m_available; }
+        // Turning it off goes straight back to full resolution.
+        void toggle();
+
+        float getScale() const { return isActive() ? m_scale : MAX_SCALE; }
+
+    private:
+        bool m_enabled = true;
+        bool m_available = false;
+        float m_scale = MAX_SCALE;
+        uint32_t m_framesSinceDecision = 0;
+    };
+
+} // namespace flint::graphics
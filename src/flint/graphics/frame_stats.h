@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flint::graphics
+{
+    struct GpuPassTime
+    {
+        const char *name;
+        double ms;
+    };
+
+    // Per-frame numbers gathered by the app for the debug screen.
+    struct FrameStats
+    {
+        // Frame pacing
+        const char *presentMode = "Fifo";
+        uint32_t frameLimit = 0; // 0 = uncapped
+        uint32_t maxFramesInFlight = 0;
+        uint32_t framesInFlight = 0;
+        double frameMs = 0.0;
+        // From the SDL event timestamp of the oldest input handled in a frame
+        // until that frame's wgpuSurfacePresent returned.
+        double inputLatencyMs = 0.0;
+        double inputLatencyPeakMs = 0.0;
+
+        // World pass resolution; below the window size when dynamic resolution kicks in
+        bool dynamicResolution = false;
+        float renderScale = 1.0f;
+        uint32_t renderWidth = 0;
+        uint32_t renderHeight = 0;
+
+        // Terrain region bundles drawn last frame and the time spent sorting them front to back
+        size_t terrainDraws = 0;
+        double drawSortMs = 0.0;
+
+        // Mesh uploads still queued, and bytes copied last frame
+        size_t uploadQueueDepth = 0;
+        uint64_t uploadQueuedBytes = 0;
+        uint64_t uploadBytes = 0;
+
+        // GPU memory from the allocation tracker; chunk meshes are what the budget evicts
+        uint64_t gpuMemoryBytes = 0;
+        uint64_t chunkMeshBytes = 0;
+        uint64_t chunkMeshBudget = 0;
+        int meshDistance = 0;
+        int viewDistance = 0;
+
+        // Day/night: 0 = midnight, 0.5 = noon; brightness is what sky light is scaled by
+        float timeOfDay = 0.0f;
+        float skyBrightness = 1.0f;
+        float daySpeed = 1.0f;
+
+        // Smoothed GPU time per pass, from timestamp queries when the adapter supports them
+        bool gpuTimestamps = false;
+        std::vector<GpuPassTime> gpuPasses;
+    };
+
+} // namespace flint::graphics
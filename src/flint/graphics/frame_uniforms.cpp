@@ -0,0 +1,255 @@
+#include "frame_uniforms.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+#include "../init/buffer.h"
+#include "../init/gpu_memory.h"
+
+namespace flint::graphics
+{
+    namespace
+    {
+        // Slot 0: the camera followed by the sky uniform.
+        constexpr size_t FRAME_UNIFORM_SIZE = sizeof(CameraUniform) + sizeof(SkyUniform);
+        static_assert(sizeof(CameraUniform) % 16 == 0);
+    }
+
+    FrameUniforms::FrameUniforms() = default;
+
+    FrameUniforms::~FrameUniforms() = default;
+
+    void FrameUniforms::init(WGPUDevice device, uint32_t initialPersistentCapacity)
+    {
+        std::cout << "Initializing frame uniforms..." << std::endl;
+
+        // Every slot must start on the device's dynamic offset alignment.
+        WGPULimits limits = {};
+        uint32_t alignment = 256;
+        if (wgpuDeviceGetLimits(device, &limits) == WGPUStatus_Success && limits.minUniformBufferOffsetAlignment > 0)
+        {
+            alignment = limits.minUniformBufferOffsetAlignment;
+        }
+        uint32_t largest = static_cast<uint32_t>(std::max(FRAME_UNIFORM_SIZE, sizeof(DrawUniform)));
+        m_slotSize = (largest + alignment - 1) / alignment * alignment;
+
+        std::vector<WGPUBindGroupLayoutEntry> bindingLayoutEntries;
+
+        // Binding 0: Camera and Sky Uniform (Vertex, Fragment)
+        WGPUBindGroupLayoutEntry cameraUniformEntry = {};
+        cameraUniformEntry.binding = 0;
+        cameraUniformEntry.visibility = WGPUShaderStage_Vertex | WGPUShaderStage_Fragment;
+        cameraUniformEntry.buffer.type = WGPUBufferBindingType_Uniform;
+        cameraUniformEntry.buffer.hasDynamicOffset = true;
+        cameraUniformEntry.buffer.minBindingSize = FRAME_UNIFORM_SIZE;
+        bindingLayoutEntries.push_back(cameraUniformEntry);
+
+        // Binding 1: Draw Uniform (Vertex)
+        WGPUBindGroupLayoutEntry drawUniformEntry = {};
+        drawUniformEntry.binding = 1;
+        drawUniformEntry.visibility = WGPUShaderStage_Vertex;
+        drawUniformEntry.buffer.type = WGPUBufferBindingType_Uniform;
+        drawUniformEntry.buffer.hasDynamicOffset = true;
+        drawUniformEntry.buffer.minBindingSize = sizeof(DrawUniform);
+        bindingLayoutEntries.push_back(drawUniformEntry);
+
+        WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc = {};
+        bindGroupLayoutDesc.entryCount = bindingLayoutEntries.size();
+        bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
+        m_bindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc);
+
+        create_buffer(device, initialPersistentCapacity, 16);
+
+        std::cout << "Frame uniforms initialized." << std::endl;
+    }
+
+    void FrameUniforms::create_buffer(WGPUDevice device, uint32_t persistentCapacity, uint32_t drawCapacity)
+    {
+        if (m_bindGroup)
+        {
+            wgpuBindGroupRelease(m_bindGroup);
+            m_bindGroup = nullptr;
+        }
+        init::release_buffer(m_buffer);
+
+        // Keep the persistent slots; per-frame slots are rewritten every frame anyway.
+        std::vector<uint8_t> previous = std::move(m_staging);
+        uint32_t keep = m_slotSize * (1 + m_persistentCapacity);
+
+        m_persistentCapacity = persistentCapacity;
+        m_drawCapacity = drawCapacity;
+        uint64_t size = static_cast<uint64_t>(m_slotSize) * (1 + m_persistentCapacity + m_drawCapacity);
+        m_buffer = init::create_uniform_buffer(device, "Frame Uniform Ring", size);
+        m_staging.assign(size, 0);
+        if (!previous.empty())
+        {
+            std::memcpy(m_staging.data(), previous.data(), std::min<size_t>(keep, previous.size()));
+        }
+
+        // The new buffer starts out empty, so every live persistent slot must go up again.
+        m_persistentDirtyBegin = m_slotSize;
+        m_persistentDirtyEnd = m_slotSize * (1 + m_persistentUsed);
+        m_cursor = transient_base();
+        ++m_generation;
+
+        std::vector<WGPUBindGroupEntry> bindings;
+
+        WGPUBindGroupEntry cameraBinding = {};
+        cameraBinding.binding = 0;
+        cameraBinding.buffer = m_buffer;
+        cameraBinding.offset = 0;
+        cameraBinding.size = FRAME_UNIFORM_SIZE;
+        bindings.push_back(cameraBinding);
+
+        WGPUBindGroupEntry drawBinding = {};
+        drawBinding.binding = 1;
+        drawBinding.buffer = m_buffer;
+        drawBinding.offset = 0;
+        drawBinding.size = sizeof(DrawUniform);
+        bindings.push_back(drawBinding);
+
+        WGPUBindGroupDescriptor bindGroupDesc = {};
+        bindGroupDesc.layout = m_bindGroupLayout;
+        bindGroupDesc.entryCount = bindings.size();
+        bindGroupDesc.entries = bindings.data();
+        m_bindGroup = wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+    }
+
+    void FrameUniforms::begin_frame(WGPUDevice device, const Camera &camera, uint32_t maxDraws)
+    {
+        if (maxDraws > m_drawCapacity)
+        {
+            uint32_t capacity = std::max(m_drawCapacity, 1u);
+            while (capacity < maxDraws)
+            {
+                capacity *= 2;
+            }
+            create_buffer(device, m_persistentCapacity, capacity);
+        }
+
+        CameraUniform cameraUniform;
+        cameraUniform.updateViewProj(camera);
+        std::memcpy(m_staging.data(), &cameraUniform, sizeof(CameraUniform));
+        std::memcpy(m_staging.data() + sizeof(CameraUniform), &m_sky, sizeof(SkyUniform));
+        m_cursor = transient_base();
+    }
+
+    uint32_t FrameUniforms::push_draw(const DrawUniform &draw)
+    {
+        if (m_cursor + m_slotSize > m_staging.size())
+        {
+            throw std::runtime_error("Frame uniform ring overflow: begin_frame was given too few draws");
+        }
+
+        uint32_t offset = m_cursor;
+        std::memcpy(m_staging.data() + offset, &draw, sizeof(DrawUniform));
+        m_cursor += m_slotSize;
+        return offset;
+    }
+
+    uint32_t FrameUniforms::allocate_persistent(WGPUDevice device, const DrawUniform &draw)
+    {
+        uint32_t slot;
+        if (!m_freePersistent.empty())
+        {
+            slot = m_freePersistent.back();
+            m_freePersistent.pop_back();
+        }
+        else
+        {
+            if (m_persistentUsed == m_persistentCapacity)
+            {
+                create_buffer(device, std::max(m_persistentCapacity * 2, 16u), m_drawCapacity);
+            }
+            slot = m_persistentUsed++;
+        }
+
+        uint32_t offset = m_slotSize * (1 + slot);
+        update_persistent(offset, draw);
+        return offset;
+    }
+
+    void FrameUniforms::update_persistent(uint32_t offset, const DrawUniform &draw)
+    {
+        std::memcpy(m_staging.data() + offset, &draw, sizeof(DrawUniform));
+        mark_persistent_dirty(offset);
+    }
+
+    void FrameUniforms::release_persistent(uint32_t offset)
+    {
+        m_freePersistent.push_back(offset / m_slotSize - 1);
+    }
+
+    void FrameUniforms::mark_persistent_dirty(uint32_t offset)
+    {
+        if (m_persistentDirtyBegin == m_persistentDirtyEnd)
+        {
+            m_persistentDirtyBegin = offset;
+            m_persistentDirtyEnd = offset + m_slotSize;
+            return;
+        }
+        m_persistentDirtyBegin = std::min(m_persistentDirtyBegin, offset);
+        m_persistentDirtyEnd = std::max(m_persistentDirtyEnd, offset + m_slotSize);
+    }
+
+    void FrameUniforms::upload(WGPUQueue queue)
+    {
+        // Camera
+        wgpuQueueWriteBuffer(queue, m_buffer, 0, m_staging.data(), m_slotSize);
+
+        // Persistent slots changed since the last upload
+        if (m_persistentDirtyEnd > m_persistentDirtyBegin)
+        {
+            wgpuQueueWriteBuffer(queue, m_buffer, m_persistentDirtyBegin,
+                                 m_staging.data() + m_persistentDirtyBegin,
+                                 m_persistentDirtyEnd - m_persistentDirtyBegin);
+            m_persistentDirtyBegin = m_persistentDirtyEnd = 0;
+        }
+
+        // Per-frame slots
+        uint32_t base = transient_base();
+        if (m_cursor > base)
+        {
+            wgpuQueueWriteBuffer(queue, m_buffer, base, m_staging.data() + base, m_cursor - base);
+        }
+    }
+
+    void FrameUniforms::bind(WGPURenderPassEncoder renderPass, uint32_t groupIndex, uint32_t drawOffset) const
+    {
+        // Dynamic offsets follow binding order: camera, then draw.
+        const uint32_t offsets[2] = {0, drawOffset};
+        wgpuRenderPassEncoderSetBindGroup(renderPass, groupIndex, m_bindGroup, 2, offsets);
+    }
+
+    void FrameUniforms::bind(WGPURenderBundleEncoder bundleEncoder, uint32_t groupIndex, uint32_t drawOffset) const
+    {
+        const uint32_t offsets[2] = {0, drawOffset};
+        wgpuRenderBundleEncoderSetBindGroup(bundleEncoder, groupIndex, m_bindGroup, 2, offsets);
+    }
+
+    void FrameUniforms::cleanup()
+    {
+        std::cout << "Cleaning up frame uniforms..." << std::endl;
+
+        if (m_bindGroup)
+        {
+            wgpuBindGroupRelease(m_bindGroup);
+            m_bindGroup = nullptr;
+        }
+        if (m_bindGroupLayout)
+        {
+            wgpuBindGroupLayoutRelease(m_bindGroupLayout);
+            m_bindGroupLayout = nullptr;
+        }
+        init::release_buffer(m_buffer);
+        m_staging.clear();
+        m_freePersistent.clear();
+        m_cursor = 0;
+        m_persistentCapacity = 0;
+        m_persistentUsed = 0;
+        m_drawCapacity = 0;
+    }
+
+} // namespace flint::graphics
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "../camera.h"
+
+namespace flint::graphics
+{
+    // Per-draw data, e.g. the world-space origin of a chunk mesh or of the selection box.
+    struct alignas(16) DrawUniform
+    {
+        glm::vec4 origin;
+    };
+
+    // Lighting values shared by the whole frame, stored right after the camera in slot 0.
+    // x scales sky light (day/night); block light will not go through it. yzw are unused.
+    struct alignas(16) SkyUniform
+    {
+        glm::vec4 sky = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+    };
+
+    // A ring of uniform slots shared by every renderer and filled once per frame.
+    //
+    // Slot 0 holds the camera and sky uniforms, the following slots hold one DrawUniform per draw.
+    // Renderers bind the shared bind group (binding 0: camera and sky, binding 1: draw) with
+    // dynamic offsets instead of owning and writing their own uniform buffers, and
+    // the whole frame is uploaded with a single wgpuQueueWriteBuffer.
+    //
+    // The write head wraps back to the start every frame. Reusing the same offsets
+    // is safe because queue writes are ordered with command buffer submissions.
+    //
+    // Between the camera and the per-frame slots sits a region of persistent slots.
+    // They keep their offset until released, so draws recorded into render bundles
+    // can bake that offset in. Growing the buffer recreates the bind group and bumps
+    // `getGeneration`, which tells bundle owners to re-record.
+    class FrameUniforms
+    {
+    public:
+        FrameUniforms();
+        ~FrameUniforms();
+
+        void init(WGPUDevice device, uint32_t initialPersistentCapacity = 1024);
+        void cleanup();
+
+        // Rewinds the ring and writes the camera for this frame. Grows the buffer
+        // beforehand if `maxDraws` slots would not fit, so the bind group stays
+        // valid for every pass recorded this frame.
+        void begin_frame(WGPUDevice device, const Camera &camera, uint32_t maxDraws);
+
+        // Sky brightness written by the next begin_frame; stays at 1 until set.
+        void set_sky_brightness(float brightness) { m_sky.sky.x = brightness; }
+
+        // Appends a draw slot and returns its dynamic offset.
+        uint32_t push_draw(const DrawUniform &draw);
+
+        // Persistent slots: the returned offset stays valid until released.
+        uint32_t allocate_persistent(WGPUDevice device, const DrawUniform &draw);
+        void update_persistent(uint32_t offset, const DrawUniform &draw);
+        void release_persistent(uint32_t offset);
+
+        // Uploads the camera, changed persistent slots and every draw slot written since begin_frame.
+        void upload(WGPUQueue queue);
+
+        // Incremented whenever the buffer and bind group are recreated.
+        uint64_t getGeneration() const { return m_generation; }
+
+        // Binds the shared group with the camera and the given draw slot.
+        void bind(WGPURenderPassEncoder renderPass, uint32_t groupIndex, uint32_t drawOffset) const;
+        void bind(WGPURenderBundleEncoder bundleEncoder, uint32_t groupIndex, uint32_t drawOffset) const;
+
+        WGPUBindGroupLayout getBindGroupLayout() const { return m_bindGroupLayout; }
+
+    private:
+        void create_buffer(WGPUDevice device, uint32_t persistentCapacity, uint32_t drawCapacity);
+        void mark_persistent_dirty(uint32_t offset);
+        uint32_t transient_base() const { return m_slotSize * (1 + m_persistentCapacity); }
+
+        WGPUBuffer m_buffer = nullptr;
+        WGPUBindGroupLayout m_bindGroupLayout = nullptr;
+        WGPUBindGroup m_bindGroup = nullptr;
+
+        SkyUniform m_sky;
+
+        std::vector<uint8_t> m_staging;
+        uint32_t m_slotSize = 256;
+        uint32_t m_drawCapacity = 0;
+        uint32_t m_cursor = 0;
+
+        uint32_t m_persistentCapacity = 0;
+        uint32_t m_persistentUsed = 0;
+        std::vector<uint32_t> m_freePersistent;
+        uint32_t m_persistentDirtyBegin = 0;
+        uint32_t m_persistentDirtyEnd = 0;
+
+        uint64_t m_generation = 0;
+    };
+
+} // namespace flint::graphics
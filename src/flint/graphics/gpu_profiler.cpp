@@ -0,0 +1,220 @@
+#include "gpu_profiler.h"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "../init/buffer.h"
+#include "../init/gpu_memory.h"
+#include "../init/utils.h"
+
+namespace flint::graphics
+{
+    namespace
+    {
+        constexpr uint32_t QUERIES_PER_SLOT = GpuProfiler::MAX_PASSES * 2;
+        // resolveQuerySet needs 256-byte aligned destination offsets; 32 queries are exactly that.
+        constexpr uint64_t SLOT_BYTES = QUERIES_PER_SLOT * sizeof(uint64_t);
+        static_assert(SLOT_BYTES % 256 == 0);
+
+        // How much each new sample moves the smoothed pass times.
+        constexpr double SMOOTHING = 0.05;
+    }
+
+    GpuProfiler::GpuProfiler() = default;
+
+    GpuProfiler::~GpuProfiler() = default;
+
+    void GpuProfiler::init(WGPUDevice device)
+    {
+        std::cout << "Initializing GPU profiler..." << std::endl;
+
+        if (!wgpuDeviceHasFeature(device, WGPUFeatureName_TimestampQuery))
+        {
+            std::cout << "GPU profiler disabled: timestamp queries are not supported by this adapter." << std::endl;
+            return;
+        }
+
+        WGPUQuerySetDescriptor querySetDesc = {};
+        querySetDesc.label = init::makeStringView("GPU Profiler Timestamps");
+        querySetDesc.type = WGPUQueryType_Timestamp;
+        querySetDesc.count = QUERIES_PER_SLOT * FRAME_SLOTS;
+        m_querySet = wgpuDeviceCreateQuerySet(device, &querySetDesc);
+        if (!m_querySet)
+        {
+            std::cerr << "GPU profiler disabled: failed to create the timestamp query set." << std::endl;
+            return;
+        }
+
+        m_resolveBuffer = init::create_buffer(
+            device,
+            "GPU Profiler Resolve Buffer",
+            SLOT_BYTES * FRAME_SLOTS,
+            WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc);
+
+        for (Slot &slot : m_slots)
+        {
+            slot.readbackBuffer = init::create_buffer(
+                device,
+                "GPU Profiler Readback Buffer",
+                SLOT_BYTES,
+                WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst);
+        }
+
+        std::cout << "GPU profiler initialized." << std::endl;
+    }
+
+    uint32_t GpuProfiler::add_pass(const char *name)
+    {
+        if (m_passNames.size() >= MAX_PASSES)
+        {
+            throw std::runtime_error("GpuProfiler: too many passes");
+        }
+        m_passNames.push_back(name);
+        return static_cast<uint32_t>(m_passNames.size() - 1);
+    }
+
+    void GpuProfiler::begin_frame()
+    {
+        m_currentSlot = NO_SLOT;
+        if (!isSupported())
+        {
+            return;
+        }
+
+        // Slots are used round-robin; if the oldest one hasn't been read back yet
+        // the GPU is far behind and this frame simply goes unmeasured.
+        Slot &slot = m_slots[m_nextSlot];
+        if (slot.pending)
+        {
+            return;
+        }
+
+        m_currentSlot = m_nextSlot;
+        m_nextSlot = (m_nextSlot + 1) % FRAME_SLOTS;
+        slot.usedPasses = 0;
+    }
+
+    const WGPUPassTimestampWrites *GpuProfiler::timestamp_writes(uint32_t pass)
+    {
+        if (m_currentSlot == NO_SLOT || pass >= m_passNames.size())
+        {
+            return nullptr;
+        }
+
+        m_slots[m_currentSlot].usedPasses |= 1u << pass;
+
+        WGPUPassTimestampWrites &writes = m_writes[pass];
+        writes.nextInChain = nullptr;
+        writes.querySet = m_querySet;
+        writes.beginningOfPassWriteIndex = m_currentSlot * QUERIES_PER_SLOT + pass * 2;
+        writes.endOfPassWriteIndex = writes.beginningOfPassWriteIndex + 1;
+        return &writes;
+    }
+
+    void GpuProfiler::resolve(WGPUCommandEncoder encoder)
+    {
+        if (m_currentSlot == NO_SLOT || m_slots[m_currentSlot].usedPasses == 0)
+        {
+            return;
+        }
+
+        uint64_t offset = m_currentSlot * SLOT_BYTES;
+        wgpuCommandEncoderResolveQuerySet(encoder, m_querySet, m_currentSlot * QUERIES_PER_SLOT, QUERIES_PER_SLOT, m_resolveBuffer, offset);
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, m_resolveBuffer, offset, m_slots[m_currentSlot].readbackBuffer, 0, SLOT_BYTES);
+    }
+
+    void GpuProfiler::after_submit()
+    {
+        if (m_currentSlot == NO_SLOT || m_slots[m_currentSlot].usedPasses == 0)
+        {
+            return;
+        }
+
+        Slot &slot = m_slots[m_currentSlot];
+        slot.pending = true;
+
+        WGPUBufferMapCallbackInfo callbackInfo = {};
+        callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        callbackInfo.callback = on_readback_mapped;
+        callbackInfo.userdata1 = this;
+        callbackInfo.userdata2 = reinterpret_cast<void *>(static_cast<uintptr_t>(m_currentSlot));
+        wgpuBufferMapAsync(slot.readbackBuffer, WGPUMapMode_Read, 0, SLOT_BYTES, callbackInfo);
+
+        m_currentSlot = NO_SLOT;
+    }
+
+    void GpuProfiler::on_readback_mapped(WGPUMapAsyncStatus status, WGPUStringView, void *userdata1, void *userdata2)
+    {
+        auto *profiler = static_cast<GpuProfiler *>(userdata1);
+        uint32_t slot = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userdata2));
+
+        if (status == WGPUMapAsyncStatus_Success)
+        {
+            profiler->read_slot(slot);
+            wgpuBufferUnmap(profiler->m_slots[slot].readbackBuffer);
+        }
+        profiler->m_slots[slot].pending = false;
+    }
+
+    void GpuProfiler::read_slot(uint32_t slotIndex)
+    {
+        const Slot &slot = m_slots[slotIndex];
+        const auto *timestamps = static_cast<const uint64_t *>(wgpuBufferGetConstMappedRange(slot.readbackBuffer, 0, SLOT_BYTES));
+        if (!timestamps)
+        {
+            return;
+        }
+
+        for (uint32_t pass = 0; pass < m_passNames.size(); ++pass)
+        {
+            if (!(slot.usedPasses & (1u << pass)))
+            {
+                continue;
+            }
+
+            // Timestamps are in nanoseconds. Some drivers occasionally report
+            // an end before the begin (e.g. across a clock change), skip those.
+            uint64_t begin = timestamps[pass * 2];
+            uint64_t end = timestamps[pass * 2 + 1];
+            if (end <= begin)
+            {
+                continue;
+            }
+
+            double ms = static_cast<double>(end - begin) / 1e6;
+            m_passMs[pass] = m_passMs[pass] == 0.0 ? ms : m_passMs[pass] + (ms - m_passMs[pass]) * SMOOTHING;
+        }
+    }
+
+    void GpuProfiler::fill_stats(FrameStats &stats) const
+    {
+        stats.gpuTimestamps = isSupported();
+        stats.gpuPasses.clear();
+        if (!isSupported())
+        {
+            return;
+        }
+
+        for (uint32_t pass = 0; pass < m_passNames.size(); ++pass)
+        {
+            stats.gpuPasses.push_back({m_passNames[pass], m_passMs[pass]});
+        }
+    }
+
+    void GpuProfiler::cleanup()
+    {
+        std::cout << "Cleaning up GPU profiler..." << std::endl;
+
+        for (Slot &slot : m_slots)
+        {
+            init::release_buffer(slot.readbackBuffer);
+        }
+        init::release_buffer(m_resolveBuffer);
+        if (m_querySet)
+        {
+            wgpuQuerySetRelease(m_querySet);
+            m_querySet = nullptr;
+        }
+    }
+
+} // namespace flint::graphics
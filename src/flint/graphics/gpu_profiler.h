@@ -0,0 +1,76 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "frame_stats.h"
+
+namespace flint::graphics
+{
+    // Measures GPU time per render or compute pass with timestamp queries.
+    //
+    // Each pass writes a begin and an end timestamp into one shared query set.
+    // Every frame resolves its queries and copies them into a readback buffer from
+    // a small ring, which is mapped asynchronously. Results arrive a few frames
+    // late and are smoothed, so the numbers on the debug screen stay readable.
+    //
+    // If the adapter lacks the timestamp-query feature, or all readback buffers
+    // are still mapped, `timestamp_writes` returns nullptr and the passes run
+    // unprofiled.
+    class GpuProfiler
+    {
+    public:
+        static constexpr uint32_t MAX_PASSES = 16;
+
+        GpuProfiler();
+        ~GpuProfiler();
+
+        void init(WGPUDevice device);
+        void cleanup();
+
+        bool isSupported() const { return m_querySet != nullptr; }
+
+        // Registers a pass by name and returns its id for `timestamp_writes`.
+        uint32_t add_pass(const char *name);
+
+        // Picks a free readback slot for this frame's queries.
+        void begin_frame();
+        // Timestamp writes for a pass descriptor, or nullptr when not profiling.
+        const WGPUPassTimestampWrites *timestamp_writes(uint32_t pass);
+        // Resolves this frame's queries into its readback slot. Call before finishing the encoder.
+        void resolve(WGPUCommandEncoder encoder);
+        // Starts reading the frame back. Call after the queue submit.
+        void after_submit();
+
+        // Adds the smoothed per-pass times to `stats`.
+        void fill_stats(FrameStats &stats) const;
+
+    private:
+        // One more than the app's frames-in-flight cap, so a slot is usually free.
+        static constexpr uint32_t FRAME_SLOTS = 4;
+        static constexpr uint32_t NO_SLOT = ~0u;
+
+        struct Slot
+        {
+            WGPUBuffer readbackBuffer = nullptr;
+            uint32_t usedPasses = 0; // bit mask of passes written this frame
+            bool pending = false;
+        };
+
+        static void on_readback_mapped(WGPUMapAsyncStatus status, WGPUStringView message, void *userdata1, void *userdata2);
+        void read_slot(uint32_t slot);
+
+        WGPUQuerySet m_querySet = nullptr;
+        WGPUBuffer m_resolveBuffer = nullptr;
+        std::array<Slot, FRAME_SLOTS> m_slots;
+        uint32_t m_nextSlot = 0;
+        uint32_t m_currentSlot = NO_SLOT;
+
+        std::vector<const char *> m_passNames;
+        std::array<double, MAX_PASSES> m_passMs = {};
+        std::array<WGPUPassTimestampWrites, MAX_PASSES> m_writes = {};
+    };
+
+} // namespace flint::graphics
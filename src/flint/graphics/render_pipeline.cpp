@@ -1,11 +1,46 @@
 #include "render_pipeline.h"
 
+#include <stdexcept>
+
 namespace flint::graphics
 {
     RenderPipeline::RenderPipeline() = default;
 
     RenderPipeline::~RenderPipeline() = default;
 
+    void RenderPipeline::createAsync(WGPUDevice device, const WGPURenderPipelineDescriptor &descriptor)
+    {
+        m_pending = true;
+        m_error.clear();
+
+        WGPUCreateRenderPipelineAsyncCallbackInfo callbackInfo = {};
+        callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        callbackInfo.callback = [](WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline, WGPUStringView message, void *userdata1, void *)
+        {
+            auto *self = static_cast<RenderPipeline *>(userdata1);
+            if (status == WGPUCreatePipelineAsyncStatus_Success)
+            {
+                self->pipeline = pipeline;
+            }
+            else
+            {
+                self->m_error = message.data && message.length > 0 ? std::string(message.data, message.length) : "Unknown error";
+            }
+            self->m_pending = false;
+        };
+        callbackInfo.userdata1 = this;
+        wgpuDeviceCreateRenderPipelineAsync(device, &descriptor, callbackInfo);
+    }
+
+    bool RenderPipeline::isReady() const
+    {
+        if (!m_error.empty())
+        {
+            throw std::runtime_error("Failed to create render pipeline: " + m_error);
+        }
+        return !m_pending;
+    }
+
     void RenderPipeline::cleanup()
     {
         if (bindGroup)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <string>
 
 namespace flint::graphics
 {
@@ -13,9 +14,21 @@ namespace flint::graphics
 
         void cleanup();
 
+        // Starts compiling the pipeline on Dawn's worker threads instead of blocking.
+        // `pipeline` is filled in when the callback runs from wgpuInstanceProcessEvents.
+        // The object must stay at the same address until then.
+        void createAsync(WGPUDevice device, const WGPURenderPipelineDescriptor &descriptor);
+
+        // True once the asynchronous creation has finished. Throws if it failed.
+        bool isReady() const;
+
         WGPURenderPipeline pipeline = nullptr;
         WGPUBindGroupLayout bindGroupLayout = nullptr;
         WGPUBindGroup bindGroup = nullptr;
+
+    private:
+        bool m_pending = false;
+        std::string m_error;
     };
 
 } // namespace flint::graphics
\ No newline at end of file
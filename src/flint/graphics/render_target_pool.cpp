@@ -0,0 +1,129 @@
+#include "render_target_pool.h"
+
+#include <iostream>
+#include <algorithm>
+
+#include "../init/gpu_memory.h"
+#include "../init/utils.h"
+
+namespace flint::graphics
+{
+    namespace
+    {
+        // About two seconds at 60 fps.
+        constexpr uint64_t FRAMES_TO_KEEP_UNUSED = 120;
+
+        bool is_depth_format(WGPUTextureFormat format)
+        {
+            switch (format)
+            {
+            case WGPUTextureFormat_Depth16Unorm:
+            case WGPUTextureFormat_Depth24Plus:
+            case WGPUTextureFormat_Depth24PlusStencil8:
+            case WGPUTextureFormat_Depth32Float:
+            case WGPUTextureFormat_Depth32FloatStencil8:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
+    RenderTargetPool::RenderTargetPool() = default;
+
+    RenderTargetPool::~RenderTargetPool() = default;
+
+    void RenderTargetPool::init(WGPUDevice device)
+    {
+        m_device = device;
+    }
+
+    RenderTarget RenderTargetPool::acquire(const char *label, uint32_t width, uint32_t height, WGPUTextureFormat format, WGPUTextureUsage usage)
+    {
+        width = std::max(width, 1u);
+        height = std::max(height, 1u);
+
+        for (Entry &entry : m_entries)
+        {
+            const RenderTarget &target = entry.target;
+            if (target.width == width && target.height == height && target.format == format && target.usage == usage)
+            {
+                entry.lastUsedFrame = m_frame;
+                return target;
+            }
+        }
+
+        RenderTarget target;
+        target.width = width;
+        target.height = height;
+        target.format = format;
+        target.usage = usage;
+
+        WGPUTextureDescriptor textureDesc = {};
+        textureDesc.label = init::makeStringView(label);
+        textureDesc.dimension = WGPUTextureDimension_2D;
+        textureDesc.format = format;
+        textureDesc.mipLevelCount = 1;
+        textureDesc.sampleCount = 1;
+        textureDesc.size = {width, height, 1};
+        textureDesc.usage = usage;
+        textureDesc.viewFormatCount = 1;
+        textureDesc.viewFormats = &format;
+        target.texture = wgpuDeviceCreateTexture(m_device, &textureDesc);
+        init::track_gpu_allocation(init::GpuMemoryKind::Texture, init::texture_size_bytes(target.texture));
+
+        WGPUTextureViewDescriptor viewDesc = {};
+        viewDesc.aspect = is_depth_format(format) ? WGPUTextureAspect_DepthOnly : WGPUTextureAspect_All;
+        viewDesc.baseArrayLayer = 0;
+        viewDesc.arrayLayerCount = 1;
+        viewDesc.baseMipLevel = 0;
+        viewDesc.mipLevelCount = 1;
+        viewDesc.dimension = WGPUTextureViewDimension_2D;
+        viewDesc.format = format;
+        target.view = wgpuTextureCreateView(target.texture, &viewDesc);
+
+        m_entries.push_back({target, m_frame});
+        return target;
+    }
+
+    void RenderTargetPool::end_frame()
+    {
+        // Releasing right after this frame's submit is fine, WebGPU keeps
+        // textures alive until the GPU work that uses them has finished.
+        for (size_t i = 0; i < m_entries.size();)
+        {
+            if (m_frame - m_entries[i].lastUsedFrame >= FRAMES_TO_KEEP_UNUSED)
+            {
+                release(m_entries[i].target);
+                m_entries[i] = m_entries.back();
+                m_entries.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        ++m_frame;
+    }
+
+    void RenderTargetPool::release(RenderTarget &target)
+    {
+        if (target.view)
+        {
+            wgpuTextureViewRelease(target.view);
+            target.view = nullptr;
+        }
+        init::release_texture(target.texture);
+    }
+
+    void RenderTargetPool::cleanup()
+    {
+        for (Entry &entry : m_entries)
+        {
+            release(entry.target);
+        }
+        m_entries.clear();
+    }
+
+} // namespace flint::graphics
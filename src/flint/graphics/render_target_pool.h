@@ -0,0 +1,57 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+#include <vector>
+
+namespace flint::graphics
+{
+    struct RenderTarget
+    {
+        WGPUTexture texture = nullptr;
+        WGPUTextureView view = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        WGPUTextureFormat format = WGPUTextureFormat_Undefined;
+        WGPUTextureUsage usage = WGPUTextureUsage_None;
+    };
+
+    // Owns the window-sized and scaled offscreen textures (color and depth).
+    //
+    // Targets are looked up by size, format and usage, so a resize or a change
+    // of render scale just asks for a different size. Targets that were not
+    // acquired for a while are released at the end of a frame. Keeping them a
+    // little longer means a scale that flips back and forth reuses them.
+    class RenderTargetPool
+    {
+    public:
+        RenderTargetPool();
+        ~RenderTargetPool();
+
+        void init(WGPUDevice device);
+        void cleanup();
+
+        // Returns a target matching the description, creating it on first use.
+        // Depth formats get a depth-only view.
+        RenderTarget acquire(const char *label, uint32_t width, uint32_t height, WGPUTextureFormat format, WGPUTextureUsage usage);
+
+        // Ages the targets and releases the ones unused for too long.
+        void end_frame();
+
+        size_t getTargetCount() const { return m_entries.size(); }
+
+    private:
+        struct Entry
+        {
+            RenderTarget target;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        static void release(RenderTarget &target);
+
+        WGPUDevice m_device = nullptr;
+        std::vector<Entry> m_entries;
+        uint64_t m_frame = 0;
+    };
+
+} // namespace flint::graphics
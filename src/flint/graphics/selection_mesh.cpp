@@ -1,6 +1,7 @@
 #include "selection_mesh.h"
 
 #include "../init/buffer.h"
+#include "../init/gpu_memory.h"
 #include "../vertex.h"
 
 #include <vector>
@@ -83,10 +84,8 @@ namespace flint::graphics
 
         m_indexCount = static_cast<uint32_t>(indices.size());
 
-        if (m_vertexBuffer)
-            wgpuBufferRelease(m_vertexBuffer);
-        if (m_indexBuffer)
-            wgpuBufferRelease(m_indexBuffer);
+        init::release_buffer(m_vertexBuffer);
+        init::release_buffer(m_indexBuffer);
 
         m_vertexBuffer = init::create_vertex_buffer(device, "Selection Vertex Buffer", vertices.data(), vertices.size() * sizeof(Vertex));
         m_indexBuffer = init::create_index_buffer(device, "Selection Index Buffer", indices.data(), indices.size() * sizeof(uint32_t));
@@ -105,16 +104,8 @@ namespace flint::graphics
 
     void SelectionMesh::cleanup()
     {
-        if (m_vertexBuffer)
-        {
-            wgpuBufferRelease(m_vertexBuffer);
-            m_vertexBuffer = nullptr;
-        }
-        if (m_indexBuffer)
-        {
-            wgpuBufferRelease(m_indexBuffer);
-            m_indexBuffer = nullptr;
-        }
+        init::release_buffer(m_vertexBuffer);
+        init::release_buffer(m_indexBuffer);
         m_indexCount = 0;
     }
 
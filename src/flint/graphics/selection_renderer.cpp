@@ -4,8 +4,6 @@
 #include <vector>
 #include <stdexcept>
 
-#include <glm/gtc/matrix_transform.hpp>
-
 #include "../init/buffer.h"
 #include "../init/shader.h"
 #include "../init/utils.h"
@@ -20,7 +18,7 @@ namespace flint::graphics
 
     SelectionRenderer::~SelectionRenderer() = default;
 
-    void SelectionRenderer::init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat)
+    void SelectionRenderer::init(WGPUDevice device, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat, const FrameUniforms &frameUniforms)
     {
         std::cout << "Initializing selection renderer..." << std::endl;
 
@@ -28,40 +26,13 @@ namespace flint::graphics
         m_vertexShader = init::create_shader_module(device, "Selection Vertex Shader", SELECTION_WGSL_vertexShaderSource.data());
         m_fragmentShader = init::create_shader_module(device, "Selection Fragment Shader", SELECTION_WGSL_fragmentShaderSource.data());
 
-        // Create uniform buffers
-        m_cameraUniformBuffer = init::create_uniform_buffer(device, "Camera Uniform Buffer", sizeof(CameraUniform));
-        m_modelUniformBuffer = init::create_uniform_buffer(device, "Model Uniform Buffer", sizeof(ModelUniform));
-
         // Create Render Pipeline
         {
-            // Create bind group layout
-            std::vector<WGPUBindGroupLayoutEntry> bindingLayoutEntries;
-
-            // Binding 0: Camera Uniform Buffer (Vertex)
-            WGPUBindGroupLayoutEntry cameraUniformEntry = {};
-            cameraUniformEntry.binding = 0;
-            cameraUniformEntry.visibility = WGPUShaderStage_Vertex;
-            cameraUniformEntry.buffer.type = WGPUBufferBindingType_Uniform;
-            cameraUniformEntry.buffer.minBindingSize = sizeof(CameraUniform);
-            bindingLayoutEntries.push_back(cameraUniformEntry);
-
-            // Binding 1: Model Uniform Buffer (Vertex)
-            WGPUBindGroupLayoutEntry modelUniformEntry = {};
-            modelUniformEntry.binding = 1;
-            modelUniformEntry.visibility = WGPUShaderStage_Vertex;
-            modelUniformEntry.buffer.type = WGPUBufferBindingType_Uniform;
-            modelUniformEntry.buffer.minBindingSize = sizeof(ModelUniform);
-            bindingLayoutEntries.push_back(modelUniformEntry);
-
-            WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc = {};
-            bindGroupLayoutDesc.entryCount = bindingLayoutEntries.size();
-            bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
-            m_renderPipeline.bindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc);
-
-            // Create pipeline layout
+            // Create pipeline layout from the shared frame uniform group
+            WGPUBindGroupLayout frameLayout = frameUniforms.getBindGroupLayout();
             WGPUPipelineLayoutDescriptor pipelineLayoutDesc = {};
             pipelineLayoutDesc.bindGroupLayoutCount = 1;
-            pipelineLayoutDesc.bindGroupLayouts = &m_renderPipeline.bindGroupLayout;
+            pipelineLayoutDesc.bindGroupLayouts = &frameLayout;
             WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &pipelineLayoutDesc);
 
             // Vertex layout
@@ -114,36 +85,11 @@ namespace flint::graphics
 
             pipelineDescriptor.layout = pipelineLayout;
 
-            m_renderPipeline.pipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDescriptor);
+            m_renderPipeline.createAsync(device, pipelineDescriptor);
 
             wgpuPipelineLayoutRelease(pipelineLayout);
         }
 
-        // Create Bind Group
-        {
-            std::vector<WGPUBindGroupEntry> bindings;
-
-            WGPUBindGroupEntry cameraBinding = {};
-            cameraBinding.binding = 0;
-            cameraBinding.buffer = m_cameraUniformBuffer;
-            cameraBinding.offset = 0;
-            cameraBinding.size = sizeof(CameraUniform);
-            bindings.push_back(cameraBinding);
-
-            WGPUBindGroupEntry modelBinding = {};
-            modelBinding.binding = 1;
-            modelBinding.buffer = m_modelUniformBuffer;
-            modelBinding.offset = 0;
-            modelBinding.size = sizeof(ModelUniform);
-            bindings.push_back(modelBinding);
-
-            WGPUBindGroupDescriptor bindGroupDesc = {};
-            bindGroupDesc.layout = m_renderPipeline.bindGroupLayout;
-            bindGroupDesc.entryCount = bindings.size();
-            bindGroupDesc.entries = bindings.data();
-            m_renderPipeline.bindGroup = wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
-        }
-
         std::cout << "Selection renderer initialized." << std::endl;
     }
 
@@ -152,7 +98,7 @@ namespace flint::graphics
         m_selectionMesh.generate(device);
     }
 
-    void SelectionRenderer::render(WGPURenderPassEncoder renderPass, WGPUQueue queue, const Camera &camera, const std::optional<glm::ivec3> &selected_block_pos)
+    void SelectionRenderer::render(WGPURenderPassEncoder renderPass, FrameUniforms &frameUniforms, const std::optional<glm::ivec3> &selected_block_pos)
     {
         is_visible = selected_block_pos.has_value();
 
@@ -161,25 +107,23 @@ namespace flint::graphics
             return;
         }
 
-        // Update camera uniform buffer
-        m_cameraUniform.updateViewProj(camera);
-        wgpuQueueWriteBuffer(queue, m_cameraUniformBuffer, 0, &m_cameraUniform, sizeof(CameraUniform));
-
-        // Update model uniform buffer
-        glm::vec3 pos = selected_block_pos.value();
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
-
-        m_modelUniform.model = model;
-        wgpuQueueWriteBuffer(queue, m_modelUniformBuffer, 0, &m_modelUniform, sizeof(ModelUniform));
+        // Place the selection box at the selected block
+        DrawUniform draw;
+        draw.origin = glm::vec4(glm::vec3(selected_block_pos.value()), 0.0f);
 
-        // Set pipeline and bind group
+        // Set pipeline and bind the frame uniforms at this draw's slot
         wgpuRenderPassEncoderSetPipeline(renderPass, m_renderPipeline.pipeline);
-        wgpuRenderPassEncoderSetBindGroup(renderPass, 0, m_renderPipeline.bindGroup, 0, nullptr);
+        frameUniforms.bind(renderPass, 0, frameUniforms.push_draw(draw));
 
         // Draw the selection mesh
         m_selectionMesh.render(renderPass);
     }
 
+    bool SelectionRenderer::isReady() const
+    {
+        return m_renderPipeline.isReady();
+    }
+
     void SelectionRenderer::cleanup()
     {
         std::cout << "Cleaning up selection renderer..." << std::endl;
@@ -187,16 +131,6 @@ namespace flint::graphics
         m_renderPipeline.cleanup();
         m_selectionMesh.cleanup();
 
-        if (m_cameraUniformBuffer)
-        {
-            wgpuBufferRelease(m_cameraUniformBuffer);
-            m_cameraUniformBuffer = nullptr;
-        }
-        if (m_modelUniformBuffer)
-        {
-            wgpuBufferRelease(m_modelUniformBuffer);
-            m_modelUniformBuffer = nullptr;
-        }
         if (m_vertexShader)
         {
             wgpuShaderModuleRelease(m_vertexShader);
@@ -6,41 +6,32 @@
 #include <glm/glm.hpp>
 #include <optional>
 
-#include "../camera.h"
+#include "frame_uniforms.h"
 #include "render_pipeline.h"
 #include "selection_mesh.h"
 
 namespace flint::graphics
 {
-    // Uniforms for the model matrix
-    struct alignas(16) ModelUniform
-    {
-        glm::mat4 model;
-    };
-
     class SelectionRenderer
     {
     public:
         SelectionRenderer();
         ~SelectionRenderer();
 
-        void init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat);
+        void init(WGPUDevice device, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat, const FrameUniforms &frameUniforms);
         void create_mesh(WGPUDevice device);
-        void render(WGPURenderPassEncoder renderPass, WGPUQueue queue, const Camera &camera, const std::optional<glm::ivec3> &selected_block_pos);
+        void render(WGPURenderPassEncoder renderPass, FrameUniforms &frameUniforms, const std::optional<glm::ivec3> &selected_block_pos);
         void cleanup();
 
+        bool isReady() const;
+
     private:
         WGPUShaderModule m_vertexShader = nullptr;
         WGPUShaderModule m_fragmentShader = nullptr;
 
+        // Only the pipeline is owned here; uniforms come from the shared frame uniform group.
         RenderPipeline m_renderPipeline;
 
-        WGPUBuffer m_cameraUniformBuffer = nullptr;
-        CameraUniform m_cameraUniform;
-
-        WGPUBuffer m_modelUniformBuffer = nullptr;
-        ModelUniform m_modelUniform;
-
         SelectionMesh m_selectionMesh;
 
         bool is_visible = false;
@@ -1,10 +1,9 @@
 #include "texture.hpp"
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include "../init/gpu_memory.h"
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cstring> // For strlen
 
 namespace {
@@ -25,23 +24,18 @@ namespace flint {
             cleanup();
         }
 
-        bool Texture::loadFromMemory(WGPUDevice device, WGPUQueue queue, const unsigned char* buffer, unsigned int len) {
+        bool Texture::loadTileArray(WGPUDevice device, WGPUQueue queue, const unsigned char* texels,
+                                    uint32_t tileSize, uint32_t layerCount, uint32_t mipLevelCount) {
             m_device = device;
-
-            int width, height, channels;
-            stbi_uc* pixels = stbi_load_from_memory(buffer, len, &width, &height, &channels, 4); // Force 4 channels (RGBA)
-
-            if (!pixels) {
-                std::cerr << "Failed to load texture from memory" << std::endl;
-                return false;
-            }
+            m_layerCount = layerCount;
+            m_mipLevelCount = mipLevelCount;
 
             // Create texture
             WGPUTextureDescriptor textureDesc = {};
             textureDesc.nextInChain = nullptr;
-            textureDesc.label = makeStringView("embedded_atlas");
-            textureDesc.size = { (uint32_t)width, (uint32_t)height, 1 };
-            textureDesc.mipLevelCount = 1;
+            textureDesc.label = makeStringView("embedded_block_array");
+            textureDesc.size = { tileSize, tileSize, m_layerCount };
+            textureDesc.mipLevelCount = m_mipLevelCount;
             textureDesc.sampleCount = 1;
             textureDesc.dimension = WGPUTextureDimension_2D;
             textureDesc.format = WGPUTextureFormat_RGBA8UnormSrgb;
@@ -52,36 +46,45 @@ namespace flint {
             m_texture = wgpuDeviceCreateTexture(device, &textureDesc);
             if (!m_texture) {
                 std::cerr << "Failed to create texture" << std::endl;
-                stbi_image_free(pixels);
                 return false;
             }
-
-            // Upload texture data using the simpler wgpuQueueWriteTexture
-            WGPUTexelCopyTextureInfo destination = {};
-            destination.texture = m_texture;
-            destination.mipLevel = 0;
-            destination.origin = { 0, 0, 0 };
-            destination.aspect = WGPUTextureAspect_All;
-
-            WGPUTexelCopyBufferLayout dataLayout = {};
-            dataLayout.offset = 0;
-            dataLayout.bytesPerRow = 4 * (uint32_t)width;
-            dataLayout.rowsPerImage = (uint32_t)height;
-
-            wgpuQueueWriteTexture(queue, &destination, pixels, (size_t)4 * (size_t)width * (size_t)height, &dataLayout, &textureDesc.size);
-
-            stbi_image_free(pixels);
+            init::track_gpu_allocation(init::GpuMemoryKind::Texture, init::texture_size_bytes(m_texture));
+
+            // Upload every mip level of all layers with one write per level,
+            // straight from the baked data.
+            uint32_t levelSize = tileSize;
+            size_t levelOffset = 0;
+            for (uint32_t level = 0; level < m_mipLevelCount; ++level) {
+                size_t levelBytes = static_cast<size_t>(levelSize) * levelSize * 4 * m_layerCount;
+
+                WGPUTexelCopyTextureInfo destination = {};
+                destination.texture = m_texture;
+                destination.mipLevel = level;
+                destination.origin = { 0, 0, 0 };
+                destination.aspect = WGPUTextureAspect_All;
+
+                WGPUTexelCopyBufferLayout dataLayout = {};
+                dataLayout.offset = 0;
+                dataLayout.bytesPerRow = 4 * levelSize;
+                dataLayout.rowsPerImage = levelSize;
+
+                WGPUExtent3D levelExtent = { levelSize, levelSize, m_layerCount };
+                wgpuQueueWriteTexture(queue, &destination, texels + levelOffset, levelBytes, &dataLayout, &levelExtent);
+
+                levelOffset += levelBytes;
+                levelSize = std::max(levelSize / 2, 1u);
+            }
 
             // Create texture view
             WGPUTextureViewDescriptor viewDesc = {};
             viewDesc.nextInChain = nullptr;
-            viewDesc.label = makeStringView("Texture View");
+            viewDesc.label = makeStringView("Texture Array View");
             viewDesc.format = WGPUTextureFormat_RGBA8UnormSrgb;
-            viewDesc.dimension = WGPUTextureViewDimension_2D;
+            viewDesc.dimension = WGPUTextureViewDimension_2DArray;
             viewDesc.baseMipLevel = 0;
-            viewDesc.mipLevelCount = 1;
+            viewDesc.mipLevelCount = m_mipLevelCount;
             viewDesc.baseArrayLayer = 0;
-            viewDesc.arrayLayerCount = 1;
+            viewDesc.arrayLayerCount = m_layerCount;
             viewDesc.aspect = WGPUTextureAspect_All;
 
             m_textureView = wgpuTextureCreateView(m_texture, &viewDesc);
@@ -91,18 +94,19 @@ namespace flint {
                 return false;
             }
 
-            // Create sampler
+            // Create sampler. Texels stay crisp up close, distant faces blend between
+            // mip levels. Repeat addressing lets one face span several blocks (LOD meshes).
             WGPUSamplerDescriptor samplerDesc = {};
             samplerDesc.nextInChain = nullptr;
-            samplerDesc.label = makeStringView("Texture Sampler");
-            samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
-            samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+            samplerDesc.label = makeStringView("Texture Array Sampler");
+            samplerDesc.addressModeU = WGPUAddressMode_Repeat;
+            samplerDesc.addressModeV = WGPUAddressMode_Repeat;
             samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
             samplerDesc.magFilter = WGPUFilterMode_Nearest;
             samplerDesc.minFilter = WGPUFilterMode_Nearest;
-            samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+            samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Linear;
             samplerDesc.lodMinClamp = 0.0f;
-            samplerDesc.lodMaxClamp = 1.0f;
+            samplerDesc.lodMaxClamp = static_cast<float>(m_mipLevelCount);
             samplerDesc.compare = WGPUCompareFunction_Undefined;
             samplerDesc.maxAnisotropy = 1;
 
@@ -113,6 +117,9 @@ namespace flint {
                 return false;
             }
 
+            std::cout << "Uploaded baked texture array: " << m_layerCount << " layers of " << tileSize << "x" << tileSize
+                      << ", " << m_mipLevelCount << " mip levels" << std::endl;
+
             return true;
         }
 
@@ -125,10 +132,7 @@ namespace flint {
                 wgpuTextureViewRelease(m_textureView);
                 m_textureView = nullptr;
             }
-            if (m_texture) {
-                wgpuTextureRelease(m_texture);
-                m_texture = nullptr;
-            }
+            init::release_texture(m_texture);
         }
 
     } // namespace graphics
@@ -2,6 +2,7 @@
 
 #include <webgpu/webgpu.h>
 #include <string>
+#include <cstdint>
 
 namespace flint {
     namespace graphics {
@@ -11,8 +12,16 @@ namespace flint {
             Texture();
             ~Texture();
 
-            // Load a texture from a memory buffer and upload it to the GPU
-            bool loadFromMemory(WGPUDevice device, WGPUQueue queue, const unsigned char* buffer, unsigned int len);
+            // Upload a texture_2d_array baked at build time by tools/bake_textures.cpp:
+            // one layer per atlas tile, with its full mip chain. `texels` holds RGBA8
+            // sRGB data in upload order (for each mip level, all layers back to back),
+            // so no decoding or mip generation happens at startup. Layers never bleed
+            // into each other when minified, which a mipmapped atlas cannot guarantee.
+            bool loadTileArray(WGPUDevice device, WGPUQueue queue, const unsigned char* texels,
+                               uint32_t tileSize, uint32_t layerCount, uint32_t mipLevelCount);
+
+            uint32_t getLayerCount() const { return m_layerCount; }
+            uint32_t getMipLevelCount() const { return m_mipLevelCount; }
 
             // Release GPU resources
             void cleanup();
@@ -26,6 +35,8 @@ namespace flint {
             WGPUTextureView m_textureView = nullptr;
             WGPUSampler m_sampler = nullptr;
             WGPUDevice m_device = nullptr; // To release resources
+            uint32_t m_layerCount = 1;
+            uint32_t m_mipLevelCount = 1;
         };
 
     } // namespace graphics
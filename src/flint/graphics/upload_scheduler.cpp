@@ -0,0 +1,289 @@
+#include "upload_scheduler.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+
+#include "../init/gpu_memory.h"
+#include "../init/utils.h"
+
+namespace flint::graphics
+{
+    namespace
+    {
+        // Pooled staging buffers are this large; bigger uploads get a buffer of their own.
+        constexpr uint64_t STAGING_BUFFER_SIZE = 1024 * 1024;
+        // Enough for a full frame budget on each of the frames the GPU may still be reading.
+        constexpr size_t MAX_STAGING_BUFFERS = 8;
+
+        constexpr uint64_t DEFAULT_BYTES_PER_FRAME = 2 * 1024 * 1024;
+        constexpr double DEFAULT_MS_PER_FRAME = 1.0;
+    }
+
+    UploadScheduler::UploadScheduler() = default;
+
+    UploadScheduler::~UploadScheduler() = default;
+
+    void UploadScheduler::init(WGPUDevice device)
+    {
+        std::cout << "Initializing upload scheduler..." << std::endl;
+        m_device = device;
+        setBudget(DEFAULT_BYTES_PER_FRAME, DEFAULT_MS_PER_FRAME);
+    }
+
+    void UploadScheduler::setBudget(uint64_t bytesPerFrame, double msPerFrame)
+    {
+        m_bytesPerFrame = bytesPerFrame;
+        m_msPerFrame = msPerFrame;
+    }
+
+    uint64_t UploadScheduler::enqueue(std::vector<BufferWrite> writes, const glm::vec3 &position, std::function<void()> onUploaded)
+    {
+        Upload upload;
+        upload.ticket = m_nextTicket++;
+        upload.position = position;
+        upload.onUploaded = std::move(onUploaded);
+        for (const BufferWrite &write : writes)
+        {
+            if (write.data.size() % 4 != 0)
+            {
+                throw std::runtime_error("UploadScheduler: write size must be a multiple of 4 bytes");
+            }
+            upload.size += write.data.size();
+        }
+        upload.writes = std::move(writes);
+
+        m_queuedBytes += upload.size;
+        m_pending.push_back(std::move(upload));
+        return m_pending.back().ticket;
+    }
+
+    void UploadScheduler::cancel(uint64_t ticket)
+    {
+        for (size_t i = 0; i < m_pending.size(); ++i)
+        {
+            if (m_pending[i].ticket == ticket)
+            {
+                m_queuedBytes -= m_pending[i].size;
+                m_pending.erase(m_pending.begin() + i);
+                return;
+            }
+        }
+    }
+
+    void UploadScheduler::record(WGPUCommandEncoder encoder, const glm::vec3 &cameraPosition)
+    {
+        m_bytesLastFrame = 0;
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed_ms = [start]()
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        m_order.clear();
+        for (uint32_t i = 0; i < m_pending.size(); ++i)
+        {
+            glm::vec3 offset = m_pending[i].position - cameraPosition;
+            m_order.add(glm::dot(offset, offset), i);
+        }
+        m_order.sort();
+
+        // Callbacks run after the queue is consistent again, so they may enqueue or cancel.
+        std::vector<std::function<void()>> uploaded;
+        m_remaining.clear();
+        bool stopped = false;
+        for (const DrawOrder::Item &item : m_order.getItems())
+        {
+            Upload &upload = m_pending[item.index];
+            if (!stopped)
+            {
+                bool overBudget = m_bytesLastFrame > 0 &&
+                                  (m_bytesLastFrame + upload.size > m_bytesPerFrame || elapsed_ms() > m_msPerFrame);
+                StagingBuffer *staging = overBudget ? nullptr : staging_for(upload.size);
+                if (staging)
+                {
+                    for (const BufferWrite &write : upload.writes)
+                    {
+                        std::memcpy(staging->mapped + staging->used, write.data.data(), write.data.size());
+                        wgpuCommandEncoderCopyBufferToBuffer(encoder, staging->buffer, staging->used, write.destination, 0, write.data.size());
+                        staging->used += write.data.size();
+                    }
+                    m_queuedBytes -= upload.size;
+                    m_bytesLastFrame += upload.size;
+                    uploaded.push_back(std::move(upload.onUploaded));
+                    continue;
+                }
+                stopped = true;
+            }
+            m_remaining.push_back(std::move(upload));
+        }
+        m_pending.swap(m_remaining);
+
+        // The copies read the staging buffers at submit, which requires them unmapped.
+        for (const std::unique_ptr<StagingBuffer> &staging : m_staging)
+        {
+            if (staging->state == StagingState::Mapped && staging->used > 0)
+            {
+                wgpuBufferUnmap(staging->buffer);
+                staging->mapped = nullptr;
+                staging->state = StagingState::InFlight;
+            }
+        }
+
+        for (std::function<void()> &callback : uploaded)
+        {
+            if (callback)
+            {
+                callback();
+            }
+        }
+    }
+
+    UploadScheduler::StagingBuffer *UploadScheduler::staging_for(uint64_t size)
+    {
+        size_t pooled = 0;
+        for (const std::unique_ptr<StagingBuffer> &staging : m_staging)
+        {
+            if (staging->oneShot)
+            {
+                continue;
+            }
+            ++pooled;
+            if (staging->state == StagingState::Mapped && staging->size - staging->used >= size)
+            {
+                return staging.get();
+            }
+        }
+
+        if (size > STAGING_BUFFER_SIZE)
+        {
+            return create_staging(size, true);
+        }
+        if (pooled < MAX_STAGING_BUFFERS)
+        {
+            return create_staging(STAGING_BUFFER_SIZE, false);
+        }
+        // Every pooled buffer is full or still in use by the GPU. The frame's
+        // first upload still goes ahead, in a buffer of its own.
+        if (m_bytesLastFrame == 0)
+        {
+            return create_staging(size, true);
+        }
+        return nullptr;
+    }
+
+    UploadScheduler::StagingBuffer *UploadScheduler::create_staging(uint64_t size, bool oneShot)
+    {
+        WGPUBufferDescriptor bufferDesc = {};
+        bufferDesc.label = init::makeStringView("Upload Staging Buffer");
+        bufferDesc.size = size;
+        bufferDesc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+        bufferDesc.mappedAtCreation = true;
+
+        auto staging = std::make_unique<StagingBuffer>();
+        staging->id = m_nextStagingId++;
+        staging->buffer = wgpuDeviceCreateBuffer(m_device, &bufferDesc);
+        init::track_gpu_allocation(init::GpuMemoryKind::Buffer, size);
+        staging->size = size;
+        staging->mapped = static_cast<uint8_t *>(wgpuBufferGetMappedRange(staging->buffer, 0, size));
+        staging->oneShot = oneShot;
+        if (!staging->mapped)
+        {
+            release_staging(*staging);
+            return nullptr;
+        }
+
+        m_staging.push_back(std::move(staging));
+        return m_staging.back().get();
+    }
+
+    void UploadScheduler::after_submit()
+    {
+        for (size_t i = 0; i < m_staging.size();)
+        {
+            StagingBuffer &staging = *m_staging[i];
+            if (staging.state != StagingState::InFlight)
+            {
+                ++i;
+                continue;
+            }
+
+            if (staging.oneShot)
+            {
+                release_staging(staging);
+                m_staging.erase(m_staging.begin() + i);
+                continue;
+            }
+
+            staging.state = StagingState::Mapping;
+
+            // The buffer is looked up by id, so a callback for a buffer released in the meantime is harmless.
+            WGPUBufferMapCallbackInfo callbackInfo = {};
+            callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+            callbackInfo.callback = on_staging_mapped;
+            callbackInfo.userdata1 = this;
+            callbackInfo.userdata2 = reinterpret_cast<void *>(static_cast<uintptr_t>(staging.id));
+            wgpuBufferMapAsync(staging.buffer, WGPUMapMode_Write, 0, staging.size, callbackInfo);
+            ++i;
+        }
+    }
+
+    void UploadScheduler::on_staging_mapped(WGPUMapAsyncStatus status, WGPUStringView, void *userdata1, void *userdata2)
+    {
+        auto *scheduler = static_cast<UploadScheduler *>(userdata1);
+        uint64_t id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(userdata2));
+
+        for (size_t i = 0; i < scheduler->m_staging.size(); ++i)
+        {
+            StagingBuffer &staging = *scheduler->m_staging[i];
+            if (staging.id != id)
+            {
+                continue;
+            }
+
+            if (status == WGPUMapAsyncStatus_Success)
+            {
+                staging.mapped = static_cast<uint8_t *>(wgpuBufferGetMappedRange(staging.buffer, 0, staging.size));
+                staging.used = 0;
+                staging.state = StagingState::Mapped;
+            }
+            if (!staging.mapped)
+            {
+                // Mapping failed; the pool creates a fresh buffer when it needs one.
+                scheduler->release_staging(staging);
+                scheduler->m_staging.erase(scheduler->m_staging.begin() + i);
+            }
+            return;
+        }
+    }
+
+    void UploadScheduler::release_staging(StagingBuffer &staging)
+    {
+        if (staging.buffer)
+        {
+            wgpuBufferDestroy(staging.buffer);
+            init::release_buffer(staging.buffer);
+        }
+        staging.mapped = nullptr;
+    }
+
+    void UploadScheduler::cleanup()
+    {
+        std::cout << "Cleaning up upload scheduler..." << std::endl;
+
+        for (const std::unique_ptr<StagingBuffer> &staging : m_staging)
+        {
+            release_staging(*staging);
+        }
+        m_staging.clear();
+        m_pending.clear();
+        m_queuedBytes = 0;
+    }
+
+} // namespace flint::graphics
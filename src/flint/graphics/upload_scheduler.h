@@ -0,0 +1,110 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "draw_order.h"
+
+namespace flint::graphics
+{
+    // Spreads buffer uploads over frames instead of writing them all at once.
+    //
+    // Uploads are queued with a world position. Every frame `record` copies the
+    // ones nearest to the camera until the byte or time budget is used up (at
+    // least one per frame, so a single large upload can't stall the queue).
+    // The data is written into staging buffers that stay mapped between uses,
+    // then copied to the destination with copyBufferToBuffer in the frame's
+    // command encoder, ahead of the passes that draw from it.
+    //
+    // A queued upload is all-or-nothing: its callback runs once every one of
+    // its writes is recorded, which is when the caller may start drawing from
+    // the destinations. Write sizes must be multiples of 4 bytes.
+    //
+    // Per frame: `record` before the first pass that reads the uploaded
+    // buffers, `after_submit` after wgpuQueueSubmit.
+    class UploadScheduler
+    {
+    public:
+        struct BufferWrite
+        {
+            WGPUBuffer destination = nullptr;
+            std::vector<uint8_t> data;
+        };
+
+        UploadScheduler();
+        ~UploadScheduler();
+
+        void init(WGPUDevice device);
+        void cleanup();
+
+        void setBudget(uint64_t bytesPerFrame, double msPerFrame);
+
+        // Queues the writes and returns a ticket for `cancel`. The destinations
+        // need CopyDst usage and must outlive the upload or its cancellation.
+        uint64_t enqueue(std::vector<BufferWrite> writes, const glm::vec3 &position, std::function<void()> onUploaded);
+        // Drops a queued upload; its callback will not run. Unknown tickets are ignored.
+        void cancel(uint64_t ticket);
+
+        void record(WGPUCommandEncoder encoder, const glm::vec3 &cameraPosition);
+        // Maps the staging buffers used this frame again, so they return to the pool.
+        void after_submit();
+
+        size_t getQueueDepth() const { return m_pending.size(); }
+        uint64_t getQueuedBytes() const { return m_queuedBytes; }
+        uint64_t getBytesLastFrame() const { return m_bytesLastFrame; }
+
+    private:
+        enum class StagingState
+        {
+            Mapped,  // free, or being filled this frame
+            InFlight, // unmapped and read by a submitted copy
+            Mapping,  // waiting for mapAsync
+        };
+
+        struct StagingBuffer
+        {
+            uint64_t id = 0;
+            WGPUBuffer buffer = nullptr;
+            uint64_t size = 0;
+            uint64_t used = 0;
+            uint8_t *mapped = nullptr;
+            StagingState state = StagingState::Mapped;
+            // Created for an upload larger than the pooled size, or for the frame's
+            // first upload when the whole pool is in use; released after use.
+            bool oneShot = false;
+        };
+
+        struct Upload
+        {
+            uint64_t ticket = 0;
+            std::vector<BufferWrite> writes;
+            uint64_t size = 0;
+            glm::vec3 position;
+            std::function<void()> onUploaded;
+        };
+
+        static void on_staging_mapped(WGPUMapAsyncStatus status, WGPUStringView message, void *userdata1, void *userdata2);
+        StagingBuffer *staging_for(uint64_t size);
+        StagingBuffer *create_staging(uint64_t size, bool oneShot);
+        void release_staging(StagingBuffer &staging);
+
+        WGPUDevice m_device = nullptr;
+        uint64_t m_bytesPerFrame = 0;
+        double m_msPerFrame = 0.0;
+
+        std::vector<Upload> m_pending;
+        std::vector<Upload> m_remaining;
+        DrawOrder m_order;
+        uint64_t m_nextTicket = 1;
+        uint64_t m_queuedBytes = 0;
+        uint64_t m_bytesLastFrame = 0;
+
+        std::vector<std::unique_ptr<StagingBuffer>> m_staging;
+        uint64_t m_nextStagingId = 1;
+    };
+
+} // namespace flint::graphics
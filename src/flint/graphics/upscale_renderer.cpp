@@ -0,0 +1,176 @@
+#include "upscale_renderer.h"
+
+#include <iostream>
+#include <vector>
+
+#include "../init/shader.h"
+#include "../init/utils.h"
+#include "../upscale_shader.wgsl.h"
+
+namespace flint::graphics
+{
+
+    UpscaleRenderer::UpscaleRenderer() = default;
+
+    UpscaleRenderer::~UpscaleRenderer() = default;
+
+    void UpscaleRenderer::init(WGPUDevice device, WGPUTextureFormat surfaceFormat)
+    {
+        std::cout << "Initializing upscale renderer..." << std::endl;
+
+        m_device = device;
+
+        // Create shaders
+        m_vertexShader = init::create_shader_module(device, "Upscale Vertex Shader", UPSCALE_WGSL_vertexShaderSource.data());
+        m_fragmentShader = init::create_shader_module(device, "Upscale Fragment Shader", UPSCALE_WGSL_fragmentShaderSource.data());
+
+        // Bilinear, clamped so the edges don't pick up texels from the opposite side.
+        WGPUSamplerDescriptor samplerDesc = {};
+        samplerDesc.label = init::makeStringView("Upscale Sampler");
+        samplerDesc.addressModeU = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeV = WGPUAddressMode_ClampToEdge;
+        samplerDesc.addressModeW = WGPUAddressMode_ClampToEdge;
+        samplerDesc.magFilter = WGPUFilterMode_Linear;
+        samplerDesc.minFilter = WGPUFilterMode_Linear;
+        samplerDesc.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+        samplerDesc.lodMinClamp = 0.0f;
+        samplerDesc.lodMaxClamp = 1.0f;
+        samplerDesc.compare = WGPUCompareFunction_Undefined;
+        samplerDesc.maxAnisotropy = 1;
+        m_sampler = wgpuDeviceCreateSampler(device, &samplerDesc);
+
+        // Create Render Pipeline
+        {
+            std::vector<WGPUBindGroupLayoutEntry> bindingLayoutEntries;
+
+            // Binding 0: Source Texture (Fragment)
+            WGPUBindGroupLayoutEntry textureEntry = {};
+            textureEntry.binding = 0;
+            textureEntry.visibility = WGPUShaderStage_Fragment;
+            textureEntry.texture.sampleType = WGPUTextureSampleType_Float;
+            textureEntry.texture.viewDimension = WGPUTextureViewDimension_2D;
+            bindingLayoutEntries.push_back(textureEntry);
+
+            // Binding 1: Sampler (Fragment)
+            WGPUBindGroupLayoutEntry samplerEntry = {};
+            samplerEntry.binding = 1;
+            samplerEntry.visibility = WGPUShaderStage_Fragment;
+            samplerEntry.sampler.type = WGPUSamplerBindingType_Filtering;
+            bindingLayoutEntries.push_back(samplerEntry);
+
+            WGPUBindGroupLayoutDescriptor bindGroupLayoutDesc = {};
+            bindGroupLayoutDesc.entryCount = bindingLayoutEntries.size();
+            bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
+            m_renderPipeline.bindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc);
+
+            WGPUPipelineLayoutDescriptor pipelineLayoutDesc = {};
+            pipelineLayoutDesc.bindGroupLayoutCount = 1;
+            pipelineLayoutDesc.bindGroupLayouts = &m_renderPipeline.bindGroupLayout;
+            WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &pipelineLayoutDesc);
+
+            // Create render pipeline descriptor
+            WGPURenderPipelineDescriptor pipelineDescriptor = {};
+            pipelineDescriptor.label = init::makeStringView("Upscale Render Pipeline");
+
+            // Vertex state: positions come from the vertex index, no buffers
+            pipelineDescriptor.vertex.module = m_vertexShader;
+            pipelineDescriptor.vertex.entryPoint = init::makeStringView("vs_main");
+            pipelineDescriptor.vertex.bufferCount = 0;
+            pipelineDescriptor.vertex.buffers = nullptr;
+
+            // Fragment state
+            WGPUFragmentState fragmentState = {};
+            fragmentState.module = m_fragmentShader;
+            fragmentState.entryPoint = init::makeStringView("fs_main");
+
+            WGPUColorTargetState colorTarget = {};
+            colorTarget.format = surfaceFormat;
+            colorTarget.writeMask = WGPUColorWriteMask_All;
+            colorTarget.blend = nullptr; // Overwrites every pixel
+
+            fragmentState.targetCount = 1;
+            fragmentState.targets = &colorTarget;
+            pipelineDescriptor.fragment = &fragmentState;
+
+            // Primitive state
+            pipelineDescriptor.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+            pipelineDescriptor.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+            pipelineDescriptor.primitive.frontFace = WGPUFrontFace_CCW;
+            pipelineDescriptor.primitive.cullMode = WGPUCullMode_None;
+
+            // No depth stencil
+            pipelineDescriptor.depthStencil = nullptr;
+
+            // Multisample state
+            pipelineDescriptor.multisample.count = 1;
+            pipelineDescriptor.multisample.mask = 0xFFFFFFFF;
+            pipelineDescriptor.multisample.alphaToCoverageEnabled = false;
+
+            pipelineDescriptor.layout = pipelineLayout;
+
+            m_renderPipeline.createAsync(device, pipelineDescriptor);
+
+            wgpuPipelineLayoutRelease(pipelineLayout);
+        }
+
+        std::cout << "Upscale renderer initialized." << std::endl;
+    }
+
+    void UpscaleRenderer::render(WGPURenderPassEncoder renderPass, WGPUTextureView source)
+    {
+        if (source != m_boundSource || !m_renderPipeline.bindGroup)
+        {
+            if (m_renderPipeline.bindGroup)
+            {
+                wgpuBindGroupRelease(m_renderPipeline.bindGroup);
+            }
+
+            WGPUBindGroupEntry entries[2] = {};
+            entries[0].binding = 0;
+            entries[0].textureView = source;
+            entries[1].binding = 1;
+            entries[1].sampler = m_sampler;
+
+            WGPUBindGroupDescriptor bindGroupDesc = {};
+            bindGroupDesc.layout = m_renderPipeline.bindGroupLayout;
+            bindGroupDesc.entryCount = 2;
+            bindGroupDesc.entries = entries;
+            m_renderPipeline.bindGroup = wgpuDeviceCreateBindGroup(m_device, &bindGroupDesc);
+            m_boundSource = source;
+        }
+
+        wgpuRenderPassEncoderSetPipeline(renderPass, m_renderPipeline.pipeline);
+        wgpuRenderPassEncoderSetBindGroup(renderPass, 0, m_renderPipeline.bindGroup, 0, nullptr);
+        wgpuRenderPassEncoderDraw(renderPass, 3, 1, 0, 0);
+    }
+
+    bool UpscaleRenderer::isReady() const
+    {
+        return m_renderPipeline.isReady();
+    }
+
+    void UpscaleRenderer::cleanup()
+    {
+        std::cout << "Cleaning up upscale renderer..." << std::endl;
+
+        m_renderPipeline.cleanup();
+        m_boundSource = nullptr;
+
+        if (m_sampler)
+        {
+            wgpuSamplerRelease(m_sampler);
+            m_sampler = nullptr;
+        }
+        if (m_vertexShader)
+        {
+            wgpuShaderModuleRelease(m_vertexShader);
+            m_vertexShader = nullptr;
+        }
+        if (m_fragmentShader)
+        {
+            wgpuShaderModuleRelease(m_fragmentShader);
+            m_fragmentShader = nullptr;
+        }
+    }
+
+} // namespace flint::graphics
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include "render_pipeline.h"
+
+namespace flint::graphics
+{
+
+    // Stretches a lower-resolution world render over the whole surface with
+    // bilinear filtering, so the UI drawn afterwards stays at full resolution.
+    class UpscaleRenderer
+    {
+    public:
+        UpscaleRenderer();
+        ~UpscaleRenderer();
+
+        void init(WGPUDevice device, WGPUTextureFormat surfaceFormat);
+        void render(WGPURenderPassEncoder renderPass, WGPUTextureView source);
+        void cleanup();
+
+        bool isReady() const;
+
+    private:
+        WGPUDevice m_device = nullptr;
+        WGPUShaderModule m_vertexShader = nullptr;
+        WGPUShaderModule m_fragmentShader = nullptr;
+        WGPUSampler m_sampler = nullptr;
+
+        RenderPipeline m_renderPipeline;
+        // The bind group is rebuilt whenever the source view changes (resize or new scale).
+        WGPUTextureView m_boundSource = nullptr;
+    };
+
+} // namespace flint::graphics
@@ -3,9 +3,14 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 
-#include "atlas_bytes.hpp"
+#include "block_textures.hpp"
 #include "../init/buffer.h"
+#include "../init/gpu_memory.h"
 #include "../init/shader.h"
 #include "../init/utils.h"
 #include "../shader.wgsl.h"
@@ -14,52 +19,80 @@
 
 namespace flint::graphics
 {
+    namespace
+    {
+        // Size of one chunk's footprint in blocks, for region distances.
+        const glm::vec2 CHUNK_FOOTPRINT = glm::vec2(static_cast<float>(CHUNK_WIDTH), static_cast<float>(CHUNK_DEPTH));
+
+        // The memory budget never shrinks the meshed area below this many chunks around the camera.
+        constexpr int MIN_MESH_DISTANCE = 2;
+
+        uint64_t chunk_mesh_memory()
+        {
+            return init::gpu_memory_used(init::GpuMemoryKind::ChunkGeometry) + init::gpu_memory_used(init::GpuMemoryKind::ChunkLight);
+        }
+    }
+
+    int ViewSettings::lod_scale_for_distance(int chunk_distance) const
+    {
+        if (chunk_distance <= full_detail_distance)
+        {
+            return 1;
+        }
+        if (chunk_distance <= full_detail_distance * 2)
+        {
+            return 2;
+        }
+        if (chunk_distance <= full_detail_distance * 4)
+        {
+            return 4;
+        }
+        return 8;
+    }
 
     WorldRenderer::WorldRenderer() = default;
 
     WorldRenderer::~WorldRenderer() = default;
 
-    void WorldRenderer::init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat)
+    void WorldRenderer::init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat, FrameUniforms &frameUniforms,
+                             UploadScheduler &uploads)
     {
         std::cout << "Initializing world renderer..." << std::endl;
 
-        // Load texture atlas
-        if (!m_atlas.loadFromMemory(device, queue, assets_textures_block_atlas_png, assets_textures_block_atlas_png_len))
+        m_device = device;
+        m_surfaceFormat = surfaceFormat;
+        m_depthTextureFormat = depthTextureFormat;
+        m_frameUniforms = &frameUniforms;
+        m_uploads = &uploads;
+        m_bundleGeneration = frameUniforms.getGeneration();
+
+        // Upload the block textures baked at build time, one array layer per atlas tile
+        if (!m_atlas.loadTileArray(device, queue, block_textures_texels, block_textures_tile_size,
+                                   block_textures_layer_count, block_textures_mip_level_count))
         {
-            std::cerr << "Failed to load texture atlas for world renderer!" << std::endl;
+            std::cerr << "Failed to load block textures for world renderer!" << std::endl;
         }
 
         // Create shaders
         m_vertexShader = init::create_shader_module(device, "World Vertex Shader", WGSL_vertexShaderSource);
         m_fragmentShader = init::create_shader_module(device, "World Fragment Shader", WGSL_fragmentShaderSource);
 
-        // Create uniform buffer for camera matrices
-        m_uniformBuffer = init::create_uniform_buffer(device, "Camera Uniform Buffer", sizeof(CameraUniform));
-
         // Create Render Pipeline
         {
-            // Create bind group layout
+            // Create bind group layout for the atlas (group 1)
             std::vector<WGPUBindGroupLayoutEntry> bindingLayoutEntries;
 
-            // Binding 0: Camera Uniform Buffer (Vertex)
-            WGPUBindGroupLayoutEntry cameraUniformEntry = {};
-            cameraUniformEntry.binding = 0;
-            cameraUniformEntry.visibility = WGPUShaderStage_Vertex;
-            cameraUniformEntry.buffer.type = WGPUBufferBindingType_Uniform;
-            cameraUniformEntry.buffer.minBindingSize = sizeof(CameraUniform);
-            bindingLayoutEntries.push_back(cameraUniformEntry);
-
-            // Binding 1: Texture View (Fragment)
+            // Binding 0: Texture View (Fragment)
             WGPUBindGroupLayoutEntry textureEntry = {};
-            textureEntry.binding = 1;
+            textureEntry.binding = 0;
             textureEntry.visibility = WGPUShaderStage_Fragment;
             textureEntry.texture.sampleType = WGPUTextureSampleType_Float;
-            textureEntry.texture.viewDimension = WGPUTextureViewDimension_2D;
+            textureEntry.texture.viewDimension = WGPUTextureViewDimension_2DArray;
             bindingLayoutEntries.push_back(textureEntry);
 
-            // Binding 2: Sampler (Fragment)
+            // Binding 1: Sampler (Fragment)
             WGPUBindGroupLayoutEntry samplerEntry = {};
-            samplerEntry.binding = 2;
+            samplerEntry.binding = 1;
             samplerEntry.visibility = WGPUShaderStage_Fragment;
             samplerEntry.sampler.type = WGPUSamplerBindingType_Filtering;
             bindingLayoutEntries.push_back(samplerEntry);
@@ -69,10 +102,23 @@ namespace flint::graphics
             bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
             m_renderPipeline.bindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bindGroupLayoutDesc);
 
-            // Create pipeline layout
+            // Create bind group layout for the per-chunk light texture (group 2)
+            WGPUBindGroupLayoutEntry lightEntry = {};
+            lightEntry.binding = 0;
+            lightEntry.visibility = WGPUShaderStage_Fragment;
+            lightEntry.texture.sampleType = WGPUTextureSampleType_Uint;
+            lightEntry.texture.viewDimension = WGPUTextureViewDimension_3D;
+
+            WGPUBindGroupLayoutDescriptor lightLayoutDesc = {};
+            lightLayoutDesc.entryCount = 1;
+            lightLayoutDesc.entries = &lightEntry;
+            m_lightBindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &lightLayoutDesc);
+
+            // Create pipeline layout: group 0 is the shared frame uniform group
+            WGPUBindGroupLayout bindGroupLayouts[3] = {frameUniforms.getBindGroupLayout(), m_renderPipeline.bindGroupLayout, m_lightBindGroupLayout};
             WGPUPipelineLayoutDescriptor pipelineLayoutDesc = {};
-            pipelineLayoutDesc.bindGroupLayoutCount = 1;
-            pipelineLayoutDesc.bindGroupLayouts = &m_renderPipeline.bindGroupLayout;
+            pipelineLayoutDesc.bindGroupLayoutCount = 3;
+            pipelineLayoutDesc.bindGroupLayouts = bindGroupLayouts;
             WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &pipelineLayoutDesc);
 
             // Vertex layout
@@ -134,7 +180,7 @@ namespace flint::graphics
 
             pipelineDescriptor.layout = pipelineLayout;
 
-            m_renderPipeline.pipeline = wgpuDeviceCreateRenderPipeline(device, &pipelineDescriptor);
+            m_renderPipeline.createAsync(device, pipelineDescriptor);
 
             wgpuPipelineLayoutRelease(pipelineLayout);
         }
@@ -143,20 +189,13 @@ namespace flint::graphics
         {
             std::vector<WGPUBindGroupEntry> bindings;
 
-            WGPUBindGroupEntry cameraBinding = {};
-            cameraBinding.binding = 0;
-            cameraBinding.buffer = m_uniformBuffer;
-            cameraBinding.offset = 0;
-            cameraBinding.size = sizeof(CameraUniform);
-            bindings.push_back(cameraBinding);
-
             WGPUBindGroupEntry textureBinding = {};
-            textureBinding.binding = 1;
+            textureBinding.binding = 0;
             textureBinding.textureView = m_atlas.getView();
             bindings.push_back(textureBinding);
 
             WGPUBindGroupEntry samplerBinding = {};
-            samplerBinding.binding = 2;
+            samplerBinding.binding = 1;
             samplerBinding.sampler = m_atlas.getSampler();
             bindings.push_back(samplerBinding);
 
@@ -168,13 +207,333 @@ namespace flint::graphics
         }
 
         std::cout << "World renderer initialized." << std::endl;
+    }
 
-        rebuild_chunk_mesh(device);
+    MeshLod WorldRenderer::lod_for_chunk(const glm::ivec2 &chunkPos) const
+    {
+        auto scale_at = [this](const glm::ivec2 &pos)
+        {
+            glm::ivec2 offset = pos - m_centerChunk;
+            return m_viewSettings.lod_scale_for_distance(std::max(std::abs(offset.x), std::abs(offset.y)));
+        };
+
+        MeshLod lod;
+        lod.scale = scale_at(chunkPos);
+        lod.neighbor_scales = {
+            scale_at(chunkPos + glm::ivec2(-1, 0)),
+            scale_at(chunkPos + glm::ivec2(1, 0)),
+            scale_at(chunkPos + glm::ivec2(0, -1)),
+            scale_at(chunkPos + glm::ivec2(0, 1))};
+        return lod;
     }
 
-    void WorldRenderer::rebuild_chunk_mesh(WGPUDevice device)
+    void WorldRenderer::build_chunk_mesh(WGPUDevice device, const glm::ivec2 &chunkPos, const MeshLod &lod)
     {
-        m_chunkMesh.generate(device, *m_world.getChunk());
+        const Chunk *chunk = m_world.getChunk(chunkPos.x, chunkPos.y);
+        if (!chunk)
+        {
+            return;
+        }
+
+        ChunkRenderData &data = m_chunkMeshes[chunkPos];
+        if (!data.mesh)
+        {
+            data.mesh = std::make_unique<ChunkMesh>();
+
+            DrawUniform draw;
+            draw.origin = glm::vec4(
+                static_cast<float>(chunkPos.x * static_cast<int>(CHUNK_WIDTH)),
+                0.0f,
+                static_cast<float>(chunkPos.y * static_cast<int>(CHUNK_DEPTH)),
+                0.0f);
+            data.uniformOffset = m_frameUniforms->allocate_persistent(device, draw);
+        }
+        // The region re-records once more when the new geometry has been uploaded.
+        data.mesh->generate(device, m_world, *chunk, lod, m_lightBindGroupLayout, *m_uploads, [this, chunkPos]()
+                            {
+                                auto regionIt = m_regions.find(region_for_chunk(chunkPos));
+                                if (regionIt != m_regions.end())
+                                {
+                                    regionIt->second.dirty = true;
+                                }
+                            });
+        data.lod = lod;
+
+        RegionBundle &region = m_regions[region_for_chunk(chunkPos)];
+        region.chunks.insert(chunkPos);
+        region.dirty = true;
+    }
+
+    void WorldRenderer::drop_chunk_mesh(const glm::ivec2 &chunkPos)
+    {
+        auto it = m_chunkMeshes.find(chunkPos);
+        if (it == m_chunkMeshes.end())
+        {
+            return;
+        }
+        m_frameUniforms->release_persistent(it->second.uniformOffset);
+        m_chunkMeshes.erase(it);
+
+        auto regionIt = m_regions.find(region_for_chunk(chunkPos));
+        if (regionIt == m_regions.end())
+        {
+            return;
+        }
+        RegionBundle &region = regionIt->second;
+        region.chunks.erase(chunkPos);
+        region.dirty = true;
+        if (region.chunks.empty())
+        {
+            if (region.bundle)
+            {
+                wgpuRenderBundleRelease(region.bundle);
+            }
+            m_regions.erase(regionIt);
+        }
+    }
+
+    glm::ivec2 WorldRenderer::region_for_chunk(const glm::ivec2 &chunkPos)
+    {
+        // Floor division, so negative chunk coordinates group the same way as positive ones.
+        return {World::floor_div(chunkPos.x, REGION_SIZE), World::floor_div(chunkPos.y, REGION_SIZE)};
+    }
+
+    glm::ivec2 WorldRenderer::order_origin_for_region(const glm::ivec2 &regionPos) const
+    {
+        glm::ivec2 regionMin = regionPos * REGION_SIZE;
+        glm::ivec2 regionMax = regionMin + glm::ivec2(REGION_SIZE - 1);
+        return glm::ivec2(
+            std::clamp(m_centerChunk.x, regionMin.x, regionMax.x),
+            std::clamp(m_centerChunk.y, regionMin.y, regionMax.y));
+    }
+
+    void WorldRenderer::record_region(const glm::ivec2 &regionPos, RegionBundle &region)
+    {
+        if (region.bundle)
+        {
+            wgpuRenderBundleRelease(region.bundle);
+            region.bundle = nullptr;
+        }
+        region.dirty = false;
+        region.orderOrigin = order_origin_for_region(regionPos);
+
+        // Nearest chunk first, seen from the camera's side of the region.
+        m_regionChunkOrder.assign(region.chunks.begin(), region.chunks.end());
+        auto distance_squared = [&region](const glm::ivec2 &chunkPos)
+        {
+            glm::ivec2 offset = chunkPos - region.orderOrigin;
+            return offset.x * offset.x + offset.y * offset.y;
+        };
+        std::sort(m_regionChunkOrder.begin(), m_regionChunkOrder.end(), [&](const glm::ivec2 &a, const glm::ivec2 &b)
+                  { return distance_squared(a) < distance_squared(b); });
+
+        WGPURenderBundleEncoderDescriptor encoderDesc = {};
+        encoderDesc.label = init::makeStringView("Terrain Region Bundle Encoder");
+        encoderDesc.colorFormatCount = 1;
+        encoderDesc.colorFormats = &m_surfaceFormat;
+        encoderDesc.depthStencilFormat = m_depthTextureFormat;
+        encoderDesc.sampleCount = 1;
+        WGPURenderBundleEncoder encoder = wgpuDeviceCreateRenderBundleEncoder(m_device, &encoderDesc);
+
+        wgpuRenderBundleEncoderSetPipeline(encoder, m_renderPipeline.pipeline);
+        wgpuRenderBundleEncoderSetBindGroup(encoder, 1, m_renderPipeline.bindGroup, 0, nullptr);
+
+        // Each chunk's origin lives in a persistent slot, so its offset can be baked into the bundle.
+        for (const glm::ivec2 &chunkPos : m_regionChunkOrder)
+        {
+            const ChunkRenderData &data = m_chunkMeshes.at(chunkPos);
+            if (data.mesh->isEmpty())
+            {
+                continue;
+            }
+            m_frameUniforms->bind(encoder, 0, data.uniformOffset);
+            wgpuRenderBundleEncoderSetBindGroup(encoder, 2, data.mesh->getLightBindGroup(), 0, nullptr);
+            data.mesh->record(encoder);
+        }
+
+        WGPURenderBundleDescriptor bundleDesc = {};
+        bundleDesc.label = init::makeStringView("Terrain Region Bundle");
+        region.bundle = wgpuRenderBundleEncoderFinish(encoder, &bundleDesc);
+        wgpuRenderBundleEncoderRelease(encoder);
+    }
+
+    void WorldRenderer::release_regions()
+    {
+        for (auto &[regionPos, region] : m_regions)
+        {
+            if (region.bundle)
+            {
+                wgpuRenderBundleRelease(region.bundle);
+                region.bundle = nullptr;
+            }
+        }
+        m_regions.clear();
+    }
+
+    void WorldRenderer::begin_world_generation(const glm::vec3 &cameraPosition)
+    {
+        glm::ivec2 centerChunk = World::chunk_coords_for(
+            static_cast<int>(std::floor(cameraPosition.x)),
+            static_cast<int>(std::floor(cameraPosition.z)));
+        int radius = m_viewSettings.view_distance + 1;
+
+        m_worldGeneration = std::async(std::launch::async, [this, centerChunk, radius]()
+                                       { m_world.load_chunks_around(centerChunk, radius); });
+    }
+
+    void WorldRenderer::update(WGPUDevice device, const glm::vec3 &cameraPosition)
+    {
+        m_cameraPosition = cameraPosition;
+
+        // The world must not be touched while the startup generation is running.
+        if (m_worldGeneration.valid())
+        {
+            m_worldGeneration.get();
+        }
+
+        // Relight this frame's block edits together before anything is meshed.
+        m_world.update_light();
+
+        glm::ivec2 centerChunk = World::chunk_coords_for(
+            static_cast<int>(std::floor(cameraPosition.x)),
+            static_cast<int>(std::floor(cameraPosition.z)));
+
+        if (!m_hasCenterChunk || centerChunk != m_centerChunk)
+        {
+            m_centerChunk = centerChunk;
+            m_hasCenterChunk = true;
+
+            const int viewDistance = m_viewSettings.view_distance;
+            const int meshDistance = std::min(viewDistance, m_meshDistance);
+
+            // Load one ring beyond the view distance so every meshed chunk has
+            // all of its neighbours available for border culling, and let go of
+            // the chunks the camera has left behind.
+            m_world.load_chunks_around(m_centerChunk, viewDistance + 1);
+            m_world.unload_chunks_beyond(m_centerChunk, viewDistance + 1);
+
+            // Drop meshes that left the meshed area.
+            for (auto it = m_chunkMeshes.begin(); it != m_chunkMeshes.end();)
+            {
+                glm::ivec2 offset = it->first - m_centerChunk;
+                if (std::max(std::abs(offset.x), std::abs(offset.y)) > meshDistance)
+                {
+                    glm::ivec2 chunkPos = it->first;
+                    ++it;
+                    drop_chunk_mesh(chunkPos);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            // Build new meshes and rebuild those whose own or neighbouring LOD changed.
+            for (int dz = -meshDistance; dz <= meshDistance; ++dz)
+            {
+                for (int dx = -meshDistance; dx <= meshDistance; ++dx)
+                {
+                    glm::ivec2 chunkPos = m_centerChunk + glm::ivec2(dx, dz);
+                    MeshLod lod = lod_for_chunk(chunkPos);
+
+                    auto it = m_chunkMeshes.find(chunkPos);
+                    if (it == m_chunkMeshes.end() || !(it->second.lod == lod))
+                    {
+                        build_chunk_mesh(device, chunkPos, lod);
+                    }
+                }
+            }
+        }
+
+        rebuild_dirty_chunk_meshes(device);
+        enforce_memory_budget();
+    }
+
+    void WorldRenderer::enforce_memory_budget()
+    {
+        const uint64_t budget = m_viewSettings.mesh_memory_budget;
+        uint64_t used = chunk_mesh_memory();
+
+        // Furthest chunks go first. Nothing else holds on to them, so an evicted
+        // chunk is simply meshed again once it is back inside the mesh distance.
+        while (used > budget && m_meshDistance > MIN_MESH_DISTANCE)
+        {
+            std::vector<glm::ivec2> evicted;
+            for (const auto &[chunkPos, data] : m_chunkMeshes)
+            {
+                glm::ivec2 offset = chunkPos - m_centerChunk;
+                if (std::max(std::abs(offset.x), std::abs(offset.y)) >= m_meshDistance)
+                {
+                    evicted.push_back(chunkPos);
+                }
+            }
+            for (const glm::ivec2 &chunkPos : evicted)
+            {
+                drop_chunk_mesh(chunkPos);
+            }
+
+            m_meshDistance = std::min(m_meshDistance, m_viewSettings.view_distance) - 1;
+            used = chunk_mesh_memory();
+        }
+
+        // Grow back only if the next ring, at today's average mesh size, leaves some headroom.
+        if (m_meshDistance < m_viewSettings.view_distance && !m_chunkMeshes.empty())
+        {
+            uint64_t perChunk = used / m_chunkMeshes.size();
+            uint64_t nextRing = perChunk * 8 * static_cast<uint64_t>(m_meshDistance + 1);
+            if (used + nextRing < budget / 10 * 9)
+            {
+                ++m_meshDistance;
+                m_hasCenterChunk = false; // the next update builds the new ring
+            }
+        }
+    }
+
+    void WorldRenderer::rebuild_dirty_chunk_meshes(WGPUDevice device)
+    {
+        std::vector<glm::ivec2> remeshed = m_world.take_dirty_chunks();
+        for (const glm::ivec2 &chunkPos : remeshed)
+        {
+            if (m_chunkMeshes.count(chunkPos))
+            {
+                build_chunk_mesh(device, chunkPos, lod_for_chunk(chunkPos));
+            }
+        }
+
+        // Light-only changes rewrite the texels of the chunk's light texture that
+        // the changed blocks feed; geometry and bundles stay as they are. A change
+        // on a chunk's border also reaches the padding of the neighbour's texture.
+        std::unordered_map<glm::ivec2, std::vector<BlockBox>> lightChanges;
+        for (const auto &[chunkPos, box] : m_world.take_light_dirty_chunks())
+        {
+            lightChanges[chunkPos].push_back(box);
+            for (const glm::ivec2 &offset : {glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1)})
+            {
+                lightChanges[chunkPos + offset].push_back(box);
+            }
+        }
+        for (const auto &[chunkPos, boxes] : lightChanges)
+        {
+            auto it = m_chunkMeshes.find(chunkPos);
+            if (it == m_chunkMeshes.end() || std::find(remeshed.begin(), remeshed.end(), chunkPos) != remeshed.end())
+            {
+                continue;
+            }
+            it->second.mesh->update_light(m_world, *m_world.getChunk(chunkPos.x, chunkPos.y), boxes);
+        }
+    }
+
+    void WorldRenderer::setViewSettings(const ViewSettings &settings)
+    {
+        m_viewSettings = settings;
+        m_meshDistance = settings.view_distance;
+        // Force the next update to re-evaluate every chunk against the new distances.
+        m_hasCenterChunk = false;
+    }
+
+    const ViewSettings &WorldRenderer::getViewSettings() const
+    {
+        return m_viewSettings;
     }
 
     World &WorldRenderer::getWorld()
@@ -187,33 +546,79 @@ namespace flint::graphics
         return m_world;
     }
 
-    void WorldRenderer::render(WGPURenderPassEncoder renderPass, WGPUQueue queue, const Camera &camera)
+    void WorldRenderer::render(WGPURenderPassEncoder renderPass)
     {
-        // Update the uniform buffer with the new camera view-projection matrix
-        m_cameraUniform.updateViewProj(camera);
-        wgpuQueueWriteBuffer(queue, m_uniformBuffer, 0, &m_cameraUniform, sizeof(CameraUniform));
+        // A regrown frame uniform buffer comes with a new bind group that every bundle has baked in.
+        if (m_frameUniforms->getGeneration() != m_bundleGeneration)
+        {
+            m_bundleGeneration = m_frameUniforms->getGeneration();
+            for (auto &[regionPos, region] : m_regions)
+            {
+                region.dirty = true;
+            }
+        }
 
-        // Set pipeline and bind group
-        wgpuRenderPassEncoderSetPipeline(renderPass, m_renderPipeline.pipeline);
-        wgpuRenderPassEncoderSetBindGroup(renderPass, 0, m_renderPipeline.bindGroup, 0, nullptr);
+        // Re-record only the regions whose meshes or chunk order changed.
+        m_drawRegions.clear();
+        for (auto &[regionPos, region] : m_regions)
+        {
+            if (region.dirty || region.orderOrigin != order_origin_for_region(regionPos))
+            {
+                record_region(regionPos, region);
+            }
+            m_drawRegions.push_back({regionPos, region.bundle});
+        }
+
+        // Front to back for early depth rejection. There is no translucent
+        // terrain yet; it would replay getItems() in reverse after these.
+        auto sortStart = std::chrono::steady_clock::now();
+        m_drawOrder.clear();
+        for (uint32_t i = 0; i < m_drawRegions.size(); ++i)
+        {
+            // Distance from the camera to the nearest point of the region's footprint.
+            glm::ivec2 regionPos = m_drawRegions[i].first;
+            glm::vec2 regionMin = glm::vec2(regionPos * REGION_SIZE) * CHUNK_FOOTPRINT;
+            glm::vec2 regionMax = regionMin + glm::vec2(REGION_SIZE) * CHUNK_FOOTPRINT;
+            glm::vec2 offset = glm::vec2(
+                m_cameraPosition.x - std::clamp(m_cameraPosition.x, regionMin.x, regionMax.x),
+                m_cameraPosition.z - std::clamp(m_cameraPosition.z, regionMin.y, regionMax.y));
+            m_drawOrder.add(glm::dot(offset, offset), i);
+        }
+        m_drawOrder.sort();
+
+        m_visibleBundles.clear();
+        for (const DrawOrder::Item &item : m_drawOrder.getItems())
+        {
+            m_visibleBundles.push_back(m_drawRegions[item.index].second);
+        }
+        m_drawSortMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sortStart).count();
 
-        // Draw the chunk
-        m_chunkMesh.render(renderPass);
+        if (!m_visibleBundles.empty())
+        {
+            wgpuRenderPassEncoderExecuteBundles(renderPass, m_visibleBundles.size(), m_visibleBundles.data());
+        }
+    }
+
+    bool WorldRenderer::isReady() const
+    {
+        return m_renderPipeline.isReady();
     }
 
     void WorldRenderer::cleanup()
     {
         std::cout << "Cleaning up world renderer..." << std::endl;
 
+        release_regions();
         m_renderPipeline.cleanup();
         m_atlas.cleanup();
-        m_chunkMesh.cleanup();
+        m_chunkMeshes.clear();
 
-        if (m_uniformBuffer)
+        if (m_lightBindGroupLayout)
         {
-            wgpuBufferRelease(m_uniformBuffer);
-            m_uniformBuffer = nullptr;
+            wgpuBindGroupLayoutRelease(m_lightBindGroupLayout);
+            m_lightBindGroupLayout = nullptr;
         }
+
         if (m_vertexShader)
         {
             wgpuShaderModuleRelease(m_vertexShader);
@@ -1,43 +1,156 @@
 #pragma once
 
 #include <webgpu/webgpu.h>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../camera.h"
 #include "../world.h"
 #include "chunk_mesh.hpp"
+#include "draw_order.h"
+#include "frame_uniforms.h"
 #include "render_pipeline.h"
 #include "texture.hpp"
+#include "upload_scheduler.h"
 
 namespace flint::graphics
 {
 
+    // How far chunks are rendered and where their meshes switch to lower detail.
+    // Distances are in chunks, measured as the Chebyshev distance from the
+    // camera's chunk, so each LOD band is a square ring.
+    struct ViewSettings
+    {
+        int view_distance = 16;
+        // Chunks up to this distance are meshed at full resolution. Each further
+        // doubling of the distance halves the resolution again: 2x up to twice
+        // this distance, 4x up to four times, 8x beyond.
+        int full_detail_distance = 4;
+        // GPU memory the chunk meshes (geometry and light) may use. Over budget,
+        // the outermost rings lose their meshes and the mesh distance shrinks;
+        // it grows back a ring at a time once the next ring fits again.
+        uint64_t mesh_memory_budget = 512ull * 1024 * 1024;
+
+        int lod_scale_for_distance(int chunk_distance) const;
+    };
+
     class WorldRenderer
     {
     public:
         WorldRenderer();
         ~WorldRenderer();
 
-        void init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat);
-        void render(WGPURenderPassEncoder renderPass, WGPUQueue queue, const Camera &camera);
+        // Chunk meshes reach the GPU through `uploads`, whose `record` must run before `render` each frame.
+        void init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat surfaceFormat, WGPUTextureFormat depthTextureFormat, FrameUniforms &frameUniforms,
+                  UploadScheduler &uploads);
+        void render(WGPURenderPassEncoder renderPass);
         void cleanup();
 
-        void rebuild_chunk_mesh(WGPUDevice device);
+        // True once the render pipeline, created asynchronously in `init`, is compiled.
+        bool isReady() const;
+
+        // Starts generating and lighting the chunks around `cameraPosition` on a
+        // worker thread, so it overlaps with device and pipeline creation. The
+        // first `update` waits for it to finish.
+        void begin_world_generation(const glm::vec3 &cameraPosition);
+
+        // Streams chunks and their meshes in around the camera position and
+        // rebuilds meshes whose level of detail changed.
+        void update(WGPUDevice device, const glm::vec3 &cameraPosition);
+
+        void setViewSettings(const ViewSettings &settings);
+        const ViewSettings &getViewSettings() const;
 
         World &getWorld();
         const World &getWorld() const;
 
+        // Distance up to which chunks currently have meshes; below the view distance when over the memory budget.
+        int getMeshDistance() const { return m_meshDistance; }
+
+        // Number of region bundles drawn last frame and how long ordering them took.
+        size_t getDrawCount() const { return m_visibleBundles.size(); }
+        double getDrawSortMs() const { return m_drawSortMs; }
+
     private:
+        struct ChunkRenderData
+        {
+            std::unique_ptr<ChunkMesh> mesh;
+            MeshLod lod;
+            // Persistent frame uniform slot holding the chunk's origin.
+            uint32_t uniformOffset = 0;
+        };
+
+        // Terrain draws are recorded into one render bundle per square region
+        // of chunks and replayed every frame. A region is re-recorded only when
+        // one of its meshes is built, rebuilt or dropped.
+        //
+        // Draw order is front to back at both levels: the bundles are sorted by
+        // distance every frame, and each bundle records its chunks nearest first
+        // as seen from `orderOrigin`, the camera's chunk clamped to the region.
+        // The region re-records when that point moves, which only happens to the
+        // regions level with the camera as it crosses a chunk border.
+        static constexpr int REGION_SIZE = 4;
+
+        struct RegionBundle
+        {
+            std::unordered_set<glm::ivec2> chunks;
+            WGPURenderBundle bundle = nullptr;
+            bool dirty = true;
+            glm::ivec2 orderOrigin = {0, 0};
+        };
+
+        static glm::ivec2 region_for_chunk(const glm::ivec2 &chunkPos);
+        glm::ivec2 order_origin_for_region(const glm::ivec2 &regionPos) const;
+
+        MeshLod lod_for_chunk(const glm::ivec2 &chunkPos) const;
+        void build_chunk_mesh(WGPUDevice device, const glm::ivec2 &chunkPos, const MeshLod &lod);
+        // Rebuilds the meshes of chunks the world reported as modified, and
+        // re-uploads the light of chunks whose light alone changed.
+        void rebuild_dirty_chunk_meshes(WGPUDevice device);
+        void drop_chunk_mesh(const glm::ivec2 &chunkPos);
+        void enforce_memory_budget();
+        void record_region(const glm::ivec2 &regionPos, RegionBundle &region);
+        void release_regions();
+
         WGPUShaderModule m_vertexShader = nullptr;
         WGPUShaderModule m_fragmentShader = nullptr;
 
+        WGPUDevice m_device = nullptr;
+        WGPUTextureFormat m_surfaceFormat = WGPUTextureFormat_Undefined;
+        WGPUTextureFormat m_depthTextureFormat = WGPUTextureFormat_Undefined;
+        FrameUniforms *m_frameUniforms = nullptr;
+        UploadScheduler *m_uploads = nullptr;
+
         World m_world;
-        ChunkMesh m_chunkMesh;
+        std::future<void> m_worldGeneration;
+        std::unordered_map<glm::ivec2, ChunkRenderData> m_chunkMeshes;
+
+        std::unordered_map<glm::ivec2, RegionBundle> m_regions;
+        std::vector<WGPURenderBundle> m_visibleBundles;
+        std::vector<glm::ivec2> m_regionChunkOrder;
+        // Region position and bundle, indexed by the draw order items.
+        std::vector<std::pair<glm::ivec2, WGPURenderBundle>> m_drawRegions;
+        DrawOrder m_drawOrder;
+        double m_drawSortMs = 0.0;
+        glm::vec3 m_cameraPosition = {0.0f, 0.0f, 0.0f};
+        // Frame uniform generation the bundles were recorded against.
+        uint64_t m_bundleGeneration = 0;
+        ViewSettings m_viewSettings;
+        int m_meshDistance = ViewSettings{}.view_distance;
+        glm::ivec2 m_centerChunk = {0, 0};
+        bool m_hasCenterChunk = false;
+
         Texture m_atlas;
 
+        // The pipeline's own bind group holds the atlas (group 1);
+        // group 0 is the shared frame uniform group.
         RenderPipeline m_renderPipeline;
-
-        WGPUBuffer m_uniformBuffer = nullptr;
-        CameraUniform m_cameraUniform;
+        // Layout of each chunk's light texture bind group (group 2).
+        WGPUBindGroupLayout m_lightBindGroupLayout = nullptr;
     };
 
 } // namespace flint::graphics
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <cstring>
 #include "utils.h"
+#include "gpu_memory.h"
 
 namespace flint::init
 {
@@ -14,6 +15,7 @@ namespace flint::init
         bufferDesc.size = size;
         bufferDesc.usage = usage;
         bufferDesc.mappedAtCreation = false;
+        track_gpu_allocation(GpuMemoryKind::Buffer, size);
         return wgpuDeviceCreateBuffer(device, &bufferDesc);
     }
 
@@ -25,6 +27,7 @@ namespace flint::init
         bufferDesc.usage = WGPUBufferUsage_Vertex;
         bufferDesc.mappedAtCreation = true;
         WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+        track_gpu_allocation(GpuMemoryKind::Buffer, size);
         void *mappedRange = wgpuBufferGetMappedRange(buffer, 0, size);
         memcpy(mappedRange, data, size);
         wgpuBufferUnmap(buffer);
@@ -39,6 +42,7 @@ namespace flint::init
         bufferDesc.usage = WGPUBufferUsage_Index;
         bufferDesc.mappedAtCreation = true;
         WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
+        track_gpu_allocation(GpuMemoryKind::Buffer, size);
         void *mappedRange = wgpuBufferGetMappedRange(buffer, 0, size);
         memcpy(mappedRange, data, size);
         wgpuBufferUnmap(buffer);
@@ -5,6 +5,7 @@
 
 namespace flint::init
 {
+    // Buffers from these functions count towards the GPU memory totals; release them with `release_buffer`.
     WGPUBuffer create_buffer(WGPUDevice device, const char *label, uint64_t size, WGPUBufferUsage usage);
 
     WGPUBuffer create_vertex_buffer(WGPUDevice device, const char *label, const void *data, uint64_t size);
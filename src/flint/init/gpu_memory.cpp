@@ -0,0 +1,109 @@
+#include "gpu_memory.h"
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+
+namespace flint::init
+{
+    namespace
+    {
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(GpuMemoryKind::Count)> g_used = {};
+
+        uint32_t bytes_per_texel(WGPUTextureFormat format)
+        {
+            switch (format)
+            {
+            case WGPUTextureFormat_R8Unorm:
+            case WGPUTextureFormat_R8Uint:
+            case WGPUTextureFormat_R8Sint:
+            case WGPUTextureFormat_Stencil8:
+                return 1;
+            case WGPUTextureFormat_RG8Unorm:
+            case WGPUTextureFormat_R16Uint:
+            case WGPUTextureFormat_R16Float:
+            case WGPUTextureFormat_Depth16Unorm:
+                return 2;
+            case WGPUTextureFormat_RGBA16Float:
+            case WGPUTextureFormat_RG32Float:
+            case WGPUTextureFormat_Depth32FloatStencil8:
+                return 8;
+            case WGPUTextureFormat_RGBA32Float:
+                return 16;
+            default:
+                // RGBA8/BGRA8 in all their variants, R32 formats and the 24/32-bit depth formats.
+                return 4;
+            }
+        }
+    }
+
+    void track_gpu_allocation(GpuMemoryKind kind, uint64_t bytes)
+    {
+        g_used[static_cast<size_t>(kind)] += bytes;
+    }
+
+    void track_gpu_release(GpuMemoryKind kind, uint64_t bytes)
+    {
+        g_used[static_cast<size_t>(kind)] -= bytes;
+    }
+
+    uint64_t gpu_memory_used(GpuMemoryKind kind)
+    {
+        return g_used[static_cast<size_t>(kind)];
+    }
+
+    uint64_t gpu_memory_used_total()
+    {
+        uint64_t total = 0;
+        for (const std::atomic<uint64_t> &used : g_used)
+        {
+            total += used;
+        }
+        return total;
+    }
+
+    uint64_t texture_size_bytes(WGPUTexture texture)
+    {
+        uint64_t width = wgpuTextureGetWidth(texture);
+        uint64_t height = wgpuTextureGetHeight(texture);
+        uint64_t depth = wgpuTextureGetDepthOrArrayLayers(texture);
+        bool is3D = wgpuTextureGetDimension(texture) == WGPUTextureDimension_3D;
+        uint64_t texel = bytes_per_texel(wgpuTextureGetFormat(texture));
+
+        uint64_t bytes = 0;
+        for (uint32_t level = 0; level < wgpuTextureGetMipLevelCount(texture); ++level)
+        {
+            bytes += width * height * depth * texel;
+            width = std::max<uint64_t>(width / 2, 1);
+            height = std::max<uint64_t>(height / 2, 1);
+            if (is3D)
+            {
+                depth = std::max<uint64_t>(depth / 2, 1);
+            }
+        }
+        return bytes;
+    }
+
+    void release_buffer(WGPUBuffer &buffer, GpuMemoryKind kind)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+        track_gpu_release(kind, wgpuBufferGetSize(buffer));
+        wgpuBufferRelease(buffer);
+        buffer = nullptr;
+    }
+
+    void release_texture(WGPUTexture &texture, GpuMemoryKind kind)
+    {
+        if (!texture)
+        {
+            return;
+        }
+        track_gpu_release(kind, texture_size_bytes(texture));
+        wgpuTextureRelease(texture);
+        texture = nullptr;
+    }
+
+} // namespace flint::init
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <cstdint>
+
+namespace flint::init
+{
+    // What a tracked allocation holds. Chunk meshes are counted on their own
+    // because they are what the world renderer evicts to stay within budget.
+    enum class GpuMemoryKind
+    {
+        Buffer,
+        Texture,
+        ChunkGeometry,
+        ChunkLight,
+        Count,
+    };
+
+    // Running totals of the GPU memory the app has allocated, per kind. WebGPU
+    // does not report usage, so the sizes are what was asked for; drivers add
+    // some alignment and bookkeeping on top.
+    void track_gpu_allocation(GpuMemoryKind kind, uint64_t bytes);
+    void track_gpu_release(GpuMemoryKind kind, uint64_t bytes);
+
+    uint64_t gpu_memory_used(GpuMemoryKind kind);
+    uint64_t gpu_memory_used_total();
+
+    // Size of a texture with all its mip levels, from the format's texel size.
+    uint64_t texture_size_bytes(WGPUTexture texture);
+
+    // Take the resource off the totals and release it. Null handles are ignored.
+    void release_buffer(WGPUBuffer &buffer, GpuMemoryKind kind = GpuMemoryKind::Buffer);
+    void release_texture(WGPUTexture &texture, GpuMemoryKind kind = GpuMemoryKind::Texture);
+
+} // namespace flint::init
@@ -15,7 +15,8 @@ namespace flint::init
     WGPURenderPassEncoder begin_render_pass(
         WGPUCommandEncoder encoder,
         WGPUTextureView textureView,
-        WGPUTextureView depthTextureView)
+        WGPUTextureView depthTextureView,
+        const WGPUPassTimestampWrites *timestampWrites)
     {
         WGPURenderPassColorAttachment colorAttachment = {};
         colorAttachment.view = textureView;
@@ -42,13 +43,15 @@ namespace flint::init
         renderPassDesc.colorAttachmentCount = 1;
         renderPassDesc.colorAttachments = &colorAttachment;
         renderPassDesc.depthStencilAttachment = &depthStencilAttachment;
+        renderPassDesc.timestampWrites = timestampWrites;
 
         return wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
     }
 
     WGPURenderPassEncoder begin_overlay_render_pass(
         WGPUCommandEncoder encoder,
-        WGPUTextureView textureView)
+        WGPUTextureView textureView,
+        const WGPUPassTimestampWrites *timestampWrites)
     {
         WGPURenderPassColorAttachment colorAttachment = {};
         colorAttachment.view = textureView;
@@ -64,6 +67,7 @@ namespace flint::init
         renderPassDesc.colorAttachmentCount = 1;
         renderPassDesc.colorAttachments = &colorAttachment;
         renderPassDesc.depthStencilAttachment = nullptr; // No depth/stencil
+        renderPassDesc.timestampWrites = timestampWrites;
 
         return wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
     }
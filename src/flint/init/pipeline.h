@@ -8,10 +8,12 @@ namespace flint::init
     WGPURenderPassEncoder begin_render_pass(
         WGPUCommandEncoder encoder,
         WGPUTextureView textureView,
-        WGPUTextureView depthTextureView);
+        WGPUTextureView depthTextureView,
+        const WGPUPassTimestampWrites *timestampWrites = nullptr);
 
     WGPURenderPassEncoder begin_overlay_render_pass(
         WGPUCommandEncoder encoder,
-        WGPUTextureView textureView);
+        WGPUTextureView textureView,
+        const WGPUPassTimestampWrites *timestampWrites = nullptr);
 
 } // namespace flint::init
\ No newline at end of file
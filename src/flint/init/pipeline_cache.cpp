@@ -0,0 +1,195 @@
+#include "pipeline_cache.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+#include "../shader.wgsl.h"
+#include "../selection_shader.wgsl.h"
+#include "../crosshair_shader.wgsl.h"
+#include "../upscale_shader.wgsl.h"
+
+namespace flint::init
+{
+    namespace
+    {
+        // Bump when the on-disk entry layout changes.
+        constexpr uint64_t CACHE_FORMAT_VERSION = 1;
+
+        uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 14695981039346656037ull)
+        {
+            const auto *bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::string to_hex(uint64_t value)
+        {
+            std::ostringstream out;
+            out << std::hex << std::setw(16) << std::setfill('0') << value;
+            return out.str();
+        }
+
+        // Reads the entry's header and checks it was stored for `key`, leaving the
+        // stream at the start of the value. Returns the value size, or 0 on mismatch.
+        size_t open_entry(std::ifstream &in, const void *key, size_t keySize)
+        {
+            uint64_t storedKeySize = 0;
+            if (!in.read(reinterpret_cast<char *>(&storedKeySize), sizeof(storedKeySize)) || storedKeySize != keySize)
+            {
+                return 0;
+            }
+
+            std::vector<char> storedKey(keySize);
+            if (!in.read(storedKey.data(), keySize) || std::memcmp(storedKey.data(), key, keySize) != 0)
+            {
+                return 0;
+            }
+
+            std::streampos valueStart = in.tellg();
+            in.seekg(0, std::ios::end);
+            std::streamoff valueSize = in.tellg() - valueStart;
+            in.seekg(valueStart);
+            return valueSize > 0 ? static_cast<size_t>(valueSize) : 0;
+        }
+    }
+
+    PipelineCache::PipelineCache(const std::filesystem::path &directory)
+    {
+        std::string version = to_hex(shader_version());
+        m_directory = directory / version;
+        m_isolationKey = "flint-" + version;
+
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (error)
+        {
+            std::cerr << "Pipeline cache disabled, cannot create " << m_directory << ": " << error.message() << std::endl;
+            return;
+        }
+        m_enabled = true;
+
+        // Anything next to the current version was built from older shaders.
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (entry.is_directory() && entry.path().filename() != version)
+            {
+                std::filesystem::remove_all(entry.path(), error);
+            }
+        }
+
+        std::cout << "Pipeline cache: " << m_directory << std::endl;
+    }
+
+    uint64_t PipelineCache::shader_version()
+    {
+        const std::string_view sources[] = {
+            WGSL_vertexShaderSource,
+            WGSL_fragmentShaderSource,
+            SELECTION_WGSL_vertexShaderSource,
+            SELECTION_WGSL_fragmentShaderSource,
+            CROSSHAIR_WGSL_vertexShaderSource,
+            CROSSHAIR_WGSL_fragmentShaderSource,
+            UPSCALE_WGSL_vertexShaderSource,
+            UPSCALE_WGSL_fragmentShaderSource,
+        };
+
+        uint64_t hash = fnv1a(&CACHE_FORMAT_VERSION, sizeof(CACHE_FORMAT_VERSION));
+        for (std::string_view source : sources)
+        {
+            hash = fnv1a(source.data(), source.size(), hash);
+        }
+        return hash;
+    }
+
+    void PipelineCache::attach(WGPUDeviceDescriptor &deviceDesc)
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        m_descriptor = {};
+        m_descriptor.chain.next = deviceDesc.nextInChain;
+        m_descriptor.chain.sType = WGPUSType_DawnCacheDeviceDescriptor;
+        m_descriptor.isolationKey = {m_isolationKey.data(), m_isolationKey.size()};
+        m_descriptor.loadDataFunction = [](const void *key, size_t keySize, void *value, size_t valueSize, void *userdata)
+        {
+            return static_cast<PipelineCache *>(userdata)->load(key, keySize, value, valueSize);
+        };
+        m_descriptor.storeDataFunction = [](const void *key, size_t keySize, const void *value, size_t valueSize, void *userdata)
+        {
+            static_cast<PipelineCache *>(userdata)->store(key, keySize, value, valueSize);
+        };
+        m_descriptor.functionUserdata = this;
+
+        deviceDesc.nextInChain = &m_descriptor.chain;
+    }
+
+    std::filesystem::path PipelineCache::path_for_key(const void *key, size_t keySize) const
+    {
+        return m_directory / (to_hex(fnv1a(key, keySize)) + ".bin");
+    }
+
+    size_t PipelineCache::load(const void *key, size_t keySize, void *value, size_t valueSize)
+    {
+        std::ifstream in(path_for_key(key, keySize), std::ios::binary);
+        size_t storedSize = in ? open_entry(in, key, keySize) : 0;
+
+        // Dawn first asks for the size with a null buffer, then loads into one
+        // of that size; only the first call is a lookup.
+        if (value == nullptr)
+        {
+            (storedSize > 0 ? m_hits : m_misses)++;
+            return storedSize;
+        }
+
+        if (storedSize == 0 || valueSize < storedSize || !in.read(static_cast<char *>(value), storedSize))
+        {
+            return 0;
+        }
+        return storedSize;
+    }
+
+    void PipelineCache::store(const void *key, size_t keySize, const void *value, size_t valueSize)
+    {
+        std::filesystem::path path = path_for_key(key, keySize);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp" + to_hex(fnv1a(value, valueSize));
+
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            uint64_t storedKeySize = keySize;
+            out.write(reinterpret_cast<const char *>(&storedKeySize), sizeof(storedKeySize));
+            out.write(static_cast<const char *>(key), keySize);
+            out.write(static_cast<const char *>(value), valueSize);
+            if (!out)
+            {
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+        m_stores++;
+    }
+
+    void PipelineCache::log_stats() const
+    {
+        std::cout << "Pipeline cache: " << m_hits << " hits, " << m_misses << " misses, " << m_stores << " stores" << std::endl;
+    }
+
+} // namespace flint::init
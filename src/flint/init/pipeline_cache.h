@@ -0,0 +1,53 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace flint::init
+{
+
+    // On-disk backing store for Dawn's blob cache, so warm starts reuse
+    // compiled shaders and pipelines instead of recompiling them from WGSL.
+    //
+    // Entries live in `<directory>/<version>/`, one file per cache key. The
+    // version is a hash of every WGSL source plus a format number, so editing
+    // a shader moves the cache to a fresh directory and removes the old one.
+    //
+    // Dawn may call the load/store hooks from its worker threads (e.g. while
+    // compiling pipelines asynchronously), so the counters are atomic and
+    // entries are written to a temporary file and renamed into place.
+    class PipelineCache
+    {
+    public:
+        explicit PipelineCache(const std::filesystem::path &directory);
+
+        // Chains the cache into a device descriptor. The cache must outlive the device.
+        void attach(WGPUDeviceDescriptor &deviceDesc);
+
+        uint64_t getHits() const { return m_hits; }
+        uint64_t getMisses() const { return m_misses; }
+        uint64_t getStores() const { return m_stores; }
+
+        void log_stats() const;
+
+    private:
+        static uint64_t shader_version();
+
+        size_t load(const void *key, size_t keySize, void *value, size_t valueSize);
+        void store(const void *key, size_t keySize, const void *value, size_t valueSize);
+        std::filesystem::path path_for_key(const void *key, size_t keySize) const;
+
+        std::filesystem::path m_directory;
+        std::string m_isolationKey;
+        bool m_enabled = false;
+        WGPUDawnCacheDeviceDescriptor m_descriptor = {};
+
+        std::atomic<uint64_t> m_hits = 0;
+        std::atomic<uint64_t> m_misses = 0;
+        std::atomic<uint64_t> m_stores = 0;
+    };
+
+} // namespace flint::init
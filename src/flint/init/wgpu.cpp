@@ -47,95 +47,115 @@ namespace
             static_cast<std::promise<WGPUDevice> *>(userdata1)->set_value(nullptr);
         }
     }
-}
 
-void flint::init::wgpu(const uint32_t width, const uint32_t height, SDL_Window *window, WGPUInstance &out_instance, WGPUSurface &out_surface, WGPUTextureFormat &out_surface_format, WGPUAdapter &out_adapter, WGPUDevice &out_device, WGPUQueue &out_queue)
-{
-    // Initialize WebGPU instance
-    auto m_instance = wgpuCreateInstance(nullptr);
-    out_instance = m_instance;
-    if (!m_instance)
+    // Creates the instance and requests an adapter and a device from it.
+    void request_device(bool forceFallbackAdapter, flint::init::PipelineCache *pipelineCache, WGPUInstance &out_instance, WGPUAdapter &out_adapter, WGPUDevice &out_device, WGPUQueue &out_queue)
     {
-        std::cerr << "Failed to create WebGPU instance" << std::endl;
-        throw std::runtime_error("Failed to create WebGPU instance");
-    }
+        // Initialize WebGPU instance
+        auto m_instance = wgpuCreateInstance(nullptr);
+        out_instance = m_instance;
+        if (!m_instance)
+        {
+            std::cerr << "Failed to create WebGPU instance" << std::endl;
+            throw std::runtime_error("Failed to create WebGPU instance");
+        }
 
-    std::cout << "WebGPU instance created" << std::endl;
+        std::cout << "WebGPU instance created" << std::endl;
 
-    std::promise<WGPUAdapter> adapter_promise;
-    auto adapter_future = adapter_promise.get_future();
+        std::promise<WGPUAdapter> adapter_promise;
+        auto adapter_future = adapter_promise.get_future();
 
-    // Request adapter
-    WGPURequestAdapterOptions adapterOptions = {};
-    adapterOptions.compatibleSurface = nullptr;
-    adapterOptions.powerPreference = WGPUPowerPreference_Undefined;
-    adapterOptions.backendType = WGPUBackendType_Undefined;
-    adapterOptions.forceFallbackAdapter = false;
+        // Request adapter
+        WGPURequestAdapterOptions adapterOptions = {};
+        adapterOptions.compatibleSurface = nullptr;
+        adapterOptions.powerPreference = WGPUPowerPreference_Undefined;
+        adapterOptions.backendType = WGPUBackendType_Undefined;
+        adapterOptions.forceFallbackAdapter = forceFallbackAdapter;
 
-    WGPURequestAdapterCallbackInfo callbackInfo = {};
-    callbackInfo.nextInChain = nullptr;
-    callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
-    callbackInfo.callback = OnAdapterReceived;
-    callbackInfo.userdata1 = &adapter_promise;
-    callbackInfo.userdata2 = nullptr;
+        WGPURequestAdapterCallbackInfo callbackInfo = {};
+        callbackInfo.nextInChain = nullptr;
+        callbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        callbackInfo.callback = OnAdapterReceived;
+        callbackInfo.userdata1 = &adapter_promise;
+        callbackInfo.userdata2 = nullptr;
 
-    std::cout << "Requesting WebGPU adapter..." << std::endl;
-    wgpuInstanceRequestAdapter(m_instance, &adapterOptions, callbackInfo);
-    while (adapter_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
-    {
-        // Process all pending WebGPU events and trigger callbacks.
-        wgpuInstanceProcessEvents(m_instance);
-    }
-    auto m_adapter = adapter_future.get();
-    if (!m_adapter)
-    {
-        throw std::runtime_error("Failed to get WGPU adapter.");
-    }
-    out_adapter = m_adapter;
-    std::cout << "WebGPU adapter obtained successfully" << std::endl;
-
-    // Request device
-    WGPUDeviceDescriptor deviceDesc = {};
-    deviceDesc.nextInChain = nullptr;
-    deviceDesc.label = {nullptr, 0};
-    deviceDesc.requiredFeatureCount = 0;
-    deviceDesc.requiredFeatures = nullptr;
-    deviceDesc.requiredLimits = nullptr;
-    deviceDesc.defaultQueue.nextInChain = nullptr;
-    deviceDesc.defaultQueue.label = {nullptr, 0};
-
-    std::promise<WGPUDevice> device_promise;
-    auto device_future = device_promise.get_future();
-
-    WGPURequestDeviceCallbackInfo deviceCallbackInfo = {};
-    deviceCallbackInfo.nextInChain = nullptr;
-    deviceCallbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
-    deviceCallbackInfo.callback = OnDeviceReceived;
-    deviceCallbackInfo.userdata1 = &device_promise;
-    deviceCallbackInfo.userdata2 = nullptr;
-
-    std::cout << "Requesting WebGPU device..." << std::endl;
-    wgpuAdapterRequestDevice(m_adapter, &deviceDesc, deviceCallbackInfo);
-
-    std::cout << "Processing events until device callback..." << std::endl;
-    while (device_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
-    {
-        // Process all pending WebGPU events and trigger callbacks.
-        wgpuInstanceProcessEvents(m_instance);
-    }
-    auto m_device = device_future.get();
-    if (!m_device)
-    {
-        std::cerr << "Failed to create WebGPU device" << std::endl;
-        throw std::runtime_error("Failed to create WebGPU device");
+        std::cout << "Requesting WebGPU adapter..." << std::endl;
+        wgpuInstanceRequestAdapter(m_instance, &adapterOptions, callbackInfo);
+        while (adapter_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            // Process all pending WebGPU events and trigger callbacks.
+            wgpuInstanceProcessEvents(m_instance);
+        }
+        auto m_adapter = adapter_future.get();
+        if (!m_adapter)
+        {
+            throw std::runtime_error("Failed to get WGPU adapter.");
+        }
+        out_adapter = m_adapter;
+        std::cout << "WebGPU adapter obtained successfully" << std::endl;
+
+        // Optional features; the renderers check for them on the device.
+        std::vector<WGPUFeatureName> requiredFeatures;
+        if (wgpuAdapterHasFeature(m_adapter, WGPUFeatureName_TimestampQuery))
+        {
+            requiredFeatures.push_back(WGPUFeatureName_TimestampQuery);
+        }
+
+        // Request device
+        WGPUDeviceDescriptor deviceDesc = {};
+        deviceDesc.nextInChain = nullptr;
+        deviceDesc.label = {nullptr, 0};
+        deviceDesc.requiredFeatureCount = requiredFeatures.size();
+        deviceDesc.requiredFeatures = requiredFeatures.data();
+        deviceDesc.requiredLimits = nullptr;
+        deviceDesc.defaultQueue.nextInChain = nullptr;
+        deviceDesc.defaultQueue.label = {nullptr, 0};
+        if (pipelineCache)
+        {
+            pipelineCache->attach(deviceDesc);
+        }
+
+        std::promise<WGPUDevice> device_promise;
+        auto device_future = device_promise.get_future();
+
+        WGPURequestDeviceCallbackInfo deviceCallbackInfo = {};
+        deviceCallbackInfo.nextInChain = nullptr;
+        deviceCallbackInfo.mode = WGPUCallbackMode_AllowProcessEvents;
+        deviceCallbackInfo.callback = OnDeviceReceived;
+        deviceCallbackInfo.userdata1 = &device_promise;
+        deviceCallbackInfo.userdata2 = nullptr;
+
+        std::cout << "Requesting WebGPU device..." << std::endl;
+        wgpuAdapterRequestDevice(m_adapter, &deviceDesc, deviceCallbackInfo);
+
+        std::cout << "Processing events until device callback..." << std::endl;
+        while (device_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            // Process all pending WebGPU events and trigger callbacks.
+            wgpuInstanceProcessEvents(m_instance);
+        }
+        auto m_device = device_future.get();
+        if (!m_device)
+        {
+            std::cerr << "Failed to create WebGPU device" << std::endl;
+            throw std::runtime_error("Failed to create WebGPU device");
+        }
+        out_device = m_device;
+        std::cout << "WebGPU device created successfully" << std::endl;
+
+        // Get the queue
+        auto m_queue = wgpuDeviceGetQueue(m_device);
+        out_queue = m_queue;
+        std::cout << "WebGPU queue obtained" << std::endl;
     }
-    out_device = m_device;
-    std::cout << "WebGPU device created successfully" << std::endl;
+}
 
-    // Get the queue
-    auto m_queue = wgpuDeviceGetQueue(m_device);
-    out_queue = m_queue;
-    std::cout << "WebGPU queue obtained" << std::endl;
+void flint::init::wgpu(const uint32_t width, const uint32_t height, SDL_Window *window, WGPUInstance &out_instance, WGPUSurface &out_surface, WGPUTextureFormat &out_surface_format, WGPUAdapter &out_adapter, WGPUDevice &out_device, WGPUQueue &out_queue, PipelineCache *pipelineCache)
+{
+    request_device(false, pipelineCache, out_instance, out_adapter, out_device, out_queue);
+    auto m_instance = out_instance;
+    auto m_adapter = out_adapter;
+    auto m_device = out_device;
 
     // Create surface
     auto m_surface = SDL_GetWGPUSurface(m_instance, window);
@@ -156,21 +176,39 @@ void flint::init::wgpu(const uint32_t width, const uint32_t height, SDL_Window *
     out_surface_format = m_surfaceFormat;
     std::cout << "Using surface format: " << m_surfaceFormat << std::endl;
 
-    // Configure the surface
+    wgpuSurfaceCapabilitiesFreeMembers(surfaceCapabilities);
+
+    // Fifo is always supported; the app may switch modes once it is running.
+    configure_surface(m_surface, m_device, m_surfaceFormat, width, height, WGPUPresentMode_Fifo);
+    std::cout << "WebGPU surface configured" << std::endl;
+}
+
+void flint::init::configure_surface(WGPUSurface surface, WGPUDevice device, WGPUTextureFormat format, uint32_t width, uint32_t height, WGPUPresentMode presentMode)
+{
     WGPUSurfaceConfiguration surfaceConfig = {};
     surfaceConfig.nextInChain = nullptr;
-    surfaceConfig.device = m_device;
-    surfaceConfig.format = m_surfaceFormat; // Common format
+    surfaceConfig.device = device;
+    surfaceConfig.format = format;
     surfaceConfig.usage = WGPUTextureUsage_RenderAttachment;
     surfaceConfig.width = width;
     surfaceConfig.height = height;
-    surfaceConfig.presentMode = WGPUPresentMode_Fifo;
+    surfaceConfig.presentMode = presentMode;
     surfaceConfig.alphaMode = WGPUCompositeAlphaMode_Auto;
     surfaceConfig.viewFormatCount = 0;
     surfaceConfig.viewFormats = nullptr;
+    wgpuSurfaceConfigure(surface, &surfaceConfig);
+}
+
+std::vector<WGPUPresentMode> flint::init::surface_present_modes(WGPUSurface surface, WGPUAdapter adapter)
+{
+    WGPUSurfaceCapabilities surfaceCapabilities = {};
+    wgpuSurfaceGetCapabilities(surface, adapter, &surfaceCapabilities);
+    std::vector<WGPUPresentMode> modes(surfaceCapabilities.presentModes, surfaceCapabilities.presentModes + surfaceCapabilities.presentModeCount);
     wgpuSurfaceCapabilitiesFreeMembers(surfaceCapabilities);
-    //
+    return modes;
+}
 
-    wgpuSurfaceConfigure(m_surface, &surfaceConfig);
-    std::cout << "WebGPU surface configured" << std::endl;
-}
\ No newline at end of file
+void flint::init::wgpu_headless(bool forceFallbackAdapter, WGPUInstance &out_instance, WGPUAdapter &out_adapter, WGPUDevice &out_device, WGPUQueue &out_queue, PipelineCache *pipelineCache)
+{
+    request_device(forceFallbackAdapter, pipelineCache, out_instance, out_adapter, out_device, out_queue);
+}
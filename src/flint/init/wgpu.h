@@ -3,6 +3,9 @@
 
 #include <webgpu/webgpu.h>
 #include <sdl3webgpu.h>
+#include <vector>
+
+#include "pipeline_cache.h"
 
 namespace flint
 {
@@ -18,7 +21,34 @@ namespace flint
             WGPUTextureFormat &out_surface_format,
             WGPUAdapter &out_adapter,
             WGPUDevice &out_device,
-            WGPUQueue &out_queue //
+            WGPUQueue &out_queue,
+            PipelineCache *pipelineCache = nullptr //
+        );
+
+        // (Re)configures the surface's swapchain; used at startup, on resize and
+        // whenever the present mode changes.
+        void configure_surface(
+            WGPUSurface surface,
+            WGPUDevice device,
+            WGPUTextureFormat format,
+            uint32_t width,
+            uint32_t height,
+            WGPUPresentMode presentMode //
+        );
+
+        // The present modes this surface supports on this adapter.
+        std::vector<WGPUPresentMode> surface_present_modes(WGPUSurface surface, WGPUAdapter adapter);
+
+        // Creates an instance, adapter, device and queue without a window or
+        // surface, for offscreen rendering. `forceFallbackAdapter` selects
+        // Dawn's software adapter, which works on machines without a GPU.
+        void wgpu_headless(
+            bool forceFallbackAdapter,
+            WGPUInstance &out_instance,
+            WGPUAdapter &out_adapter,
+            WGPUDevice &out_device,
+            WGPUQueue &out_queue,
+            PipelineCache *pipelineCache = nullptr //
         );
     } // namespace init
 
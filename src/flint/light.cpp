@@ -1,202 +1,1053 @@
 #include "light.h"
 #include "chunk.h"
+#include "light_queue.h"
 #include <algorithm>
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLINT_LIGHT_SLABS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FLINT_LIGHT_SLABS_NEON
+#include <arm_neon.h>
+#endif
 
 namespace flint
 {
-
-    void Light::calculate_sky_light(World *world)
+    namespace
     {
-        Chunk *chunk = world->getChunk();
-        // Phase 0: Reset
-        for (int x = 0; x < CHUNK_WIDTH; ++x)
+        constexpr uint8_t MAX_LIGHT = 15;
+        // Light only leaves a block with at least 2, so dimmer border blocks need not be queued.
+        constexpr uint8_t MIN_LIGHT_TO_CROSS_BORDER = 2;
+
+        constexpr size_t CHUNK_VOLUME = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+        // Steps through Chunk::blocks().
+        constexpr size_t BLOCK_STRIDE_X = CHUNK_HEIGHT * CHUNK_DEPTH;
+        constexpr size_t BLOCK_STRIDE_Y = CHUNK_DEPTH;
+
+        // A fill works inside a window of chunks: the chunks it starts in plus a
+        // margin. Light travels at most 15 blocks; taking light away and refilling
+        // behind it stays within twice that, so two chunks on every side suffice.
+        constexpr int WINDOW_MARGIN = 2;
+
+        // A voxel of the window packs into 32 bits as y | z << Z_SHIFT | x << X_SHIFT,
+        // so stepping to a neighbour is one add. Removal entries also carry the light
+        // being taken away, above LIGHT_SHIFT.
+        constexpr uint32_t Y_BITS = std::bit_width(CHUNK_HEIGHT - 1);
+        constexpr uint32_t XZ_BITS = 11;
+        constexpr uint32_t Z_SHIFT = Y_BITS;
+        constexpr uint32_t X_SHIFT = Z_SHIFT + XZ_BITS;
+        constexpr uint32_t Y_MASK = (1u << Y_BITS) - 1;
+        constexpr uint32_t XZ_MASK = (1u << XZ_BITS) - 1;
+        constexpr uint32_t LIGHT_SHIFT = 28;
+        constexpr uint32_t VOXEL_MASK = (1u << LIGHT_SHIFT) - 1;
+        static_assert(std::has_single_bit(CHUNK_WIDTH) && std::has_single_bit(CHUNK_HEIGHT) && std::has_single_bit(CHUNK_DEPTH));
+        static_assert(X_SHIFT + XZ_BITS <= LIGHT_SHIFT);
+
+        // The widest window, margins included, that the packed coordinates can address.
+        constexpr int MAX_WINDOW_CHUNKS = (1 << XZ_BITS) / static_cast<int>(std::max(CHUNK_WIDTH, CHUNK_DEPTH));
+
+        enum Direction
+        {
+            NEG_X,
+            POS_X,
+            NEG_Y,
+            POS_Y,
+            NEG_Z,
+            POS_Z,
+            DIRECTION_COUNT,
+        };
+
+        // Per direction: what to add to a packed voxel to step that way, and the
+        // coordinate field that must not already sit at `edge` (the window's or world's last block).
+        struct Step
+        {
+            uint32_t delta;
+            uint32_t shift;
+            uint32_t mask;
+            uint32_t edge;
+        };
+
+        using Steps = std::array<Step, DIRECTION_COUNT>;
+
+        // The far x and z edges depend on the window's size and are filled in per window.
+        constexpr Steps BASE_STEPS = {{
+            {0u - (1u << X_SHIFT), X_SHIFT, XZ_MASK, 0},
+            {1u << X_SHIFT, X_SHIFT, XZ_MASK, 0},
+            {0u - 1u, 0, Y_MASK, 0},
+            {1u, 0, Y_MASK, CHUNK_HEIGHT - 1},
+            {0u - (1u << Z_SHIFT), Z_SHIFT, XZ_MASK, 0},
+            {1u << Z_SHIFT, Z_SHIFT, XZ_MASK, 0},
+        }};
+
+        // The chunk side a horizontal step crosses when it leaves a chunk.
+        constexpr std::array<int, DIRECTION_COUNT> STEP_SIDES = {
+            CHUNK_SIDE_NEG_X, CHUNK_SIDE_POS_X, -1, -1, CHUNK_SIDE_NEG_Z, CHUNK_SIDE_POS_Z};
+
+        // Offset from a chunk to its neighbour on each side.
+        const std::array<glm::ivec2, CHUNK_SIDE_COUNT> SIDE_OFFSETS = {
+            glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1)};
+
+        bool can_step(uint32_t voxel, const Step &step)
+        {
+            return (voxel >> step.shift & step.mask) != step.edge;
+        }
+
+        // A light value a fill or removal overwrote, kept while the window records writes.
+        struct LightWrite
+        {
+            uint32_t voxel;
+            uint16_t index; // into the chunk's blocks
+            uint8_t old_light;
+            bool darkens; // a removal's write, which never raises the light
+        };
+        thread_local std::vector<LightWrite> t_lightWrites;
+        // Per chunk of the window, the box around the blocks whose light changed.
+        thread_local std::vector<BlockBox> t_changedBoxes;
+        thread_local std::vector<uint8_t> t_changedBoxFlags;
+        // Per chunk of the window, a bit for each section that was written to.
+        thread_local std::vector<uint8_t> t_writtenSections;
+        // A bit per block of the window, set for the darkened ones while the
+        // changes are collected and cleared again before the next pass.
+        thread_local std::vector<uint64_t> t_darkenedBlocks;
+        static_assert(SECTION_COUNT <= 8 && CHUNK_VOLUME <= 0x10000);
+
+        // A block inside a window: the chunk holding it and its index into
+        // Chunk::blocks(), where the chunk's light is looked up too.
+        struct BlockRef
+        {
+            Chunk *chunk;
+            size_t index;
+
+            explicit operator bool() const { return chunk != nullptr; }
+            const Block &block() const { return chunk->blocks()[index]; }
+        };
+
+        // Chunk table of the thread's current window. Windows are never nested,
+        // so one table per thread is reused instead of allocating one per fill.
+        thread_local std::vector<Chunk *> t_windowChunks;
+
+        // The chunks a fill may touch, looked up once so that finding a voxel's
+        // block is a little arithmetic instead of a World::getBlock hash lookup.
+        class LightWindow
+        {
+        public:
+            // The loaded chunks from `minChunk` to `maxChunk` (inclusive), plus the
+            // margin. Light stepping into a chunk that is not loaded is queued on the
+            // border it would cross. The area must `fit`.
+            LightWindow(World *world, const glm::ivec2 &minChunk, const glm::ivec2 &maxChunk)
+                : LightWindow(minChunk, maxChunk, true)
+            {
+                for (int cx = 0; cx < m_size.x; ++cx)
+                {
+                    for (int cz = 0; cz < m_size.y; ++cz)
+                    {
+                        m_chunks[cx * m_size.y + cz] = world->getChunk(m_origin.x + cx, m_origin.y + cz);
+                    }
+                }
+            }
+
+            // Only `chunk`, lit on its own; light reaching its borders stops there.
+            explicit LightWindow(Chunk *chunk)
+                : LightWindow(glm::ivec2(chunk->getChunkX(), chunk->getChunkZ()), glm::ivec2(chunk->getChunkX(), chunk->getChunkZ()), false)
+            {
+                m_chunks[WINDOW_MARGIN * m_size.y + WINDOW_MARGIN] = chunk;
+            }
+
+            static bool fits(const glm::ivec2 &minChunk, const glm::ivec2 &maxChunk)
+            {
+                glm::ivec2 size = maxChunk - minChunk + glm::ivec2(1 + 2 * WINDOW_MARGIN);
+                return size.x <= MAX_WINDOW_CHUNKS && size.y <= MAX_WINDOW_CHUNKS;
+            }
+
+            const Steps &steps() const { return m_steps; }
+
+            // Has every light write through `set_light` logged to t_lightWrites.
+            void record_writes() { m_writes = &t_lightWrites; }
+            std::vector<LightWrite> *writes() const { return m_writes; }
+
+            // Packs a world position, which must lie inside the window.
+            uint32_t pack(int x, int y, int z) const
+            {
+                uint32_t wx = static_cast<uint32_t>(x - m_origin.x * static_cast<int>(CHUNK_WIDTH));
+                uint32_t wz = static_cast<uint32_t>(z - m_origin.y * static_cast<int>(CHUNK_DEPTH));
+                return wx << X_SHIFT | wz << Z_SHIFT | static_cast<uint32_t>(y);
+            }
+
+            glm::ivec3 position(uint32_t voxel) const
+            {
+                return glm::ivec3(m_origin.x * static_cast<int>(CHUNK_WIDTH) + static_cast<int>(voxel >> X_SHIFT & XZ_MASK),
+                                  static_cast<int>(voxel & Y_MASK),
+                                  m_origin.y * static_cast<int>(CHUNK_DEPTH) + static_cast<int>(voxel >> Z_SHIFT & XZ_MASK));
+            }
+
+            // Index of the voxel's chunk in the window, below `slot_count`.
+            size_t slot(uint32_t voxel) const
+            {
+                uint32_t cx = (voxel >> X_SHIFT & XZ_MASK) / CHUNK_WIDTH;
+                uint32_t cz = (voxel >> Z_SHIFT & XZ_MASK) / CHUNK_DEPTH;
+                return cx * m_size.y + cz;
+            }
+            size_t slot_count() const { return m_chunks.size(); }
+            glm::ivec2 slot_chunk(size_t slot) const
+            {
+                return m_origin + glm::ivec2(static_cast<int>(slot) / m_size.y, static_cast<int>(slot) % m_size.y);
+            }
+
+            Chunk *chunk_in_slot(size_t slot) const { return m_chunks[slot]; }
+
+            Chunk *chunk(uint32_t voxel) const
+            {
+                return m_chunks[slot(voxel)];
+            }
+
+            // The block at `voxel`; its chunk is nullptr if not loaded.
+            BlockRef at(uint32_t voxel) const
+            {
+                uint32_t x = (voxel >> X_SHIFT & XZ_MASK) % CHUNK_WIDTH;
+                uint32_t z = (voxel >> Z_SHIFT & XZ_MASK) % CHUNK_DEPTH;
+                return {chunk(voxel), x * BLOCK_STRIDE_X + (voxel & Y_MASK) * BLOCK_STRIDE_Y + z};
+            }
+
+            // Light from `from` could not step towards `direction` because that chunk is
+            // not loaded. Remembers `from` on the border it faces, to be replayed when
+            // that chunk loads.
+            void queue_for_unloaded_neighbor(uint32_t from, int direction) const
+            {
+                if (!m_queueBorders)
+                {
+                    return;
+                }
+                chunk(from)->queue_border_light(STEP_SIDES[direction], {(from >> X_SHIFT & XZ_MASK) % CHUNK_WIDTH,
+                                                                        from & Y_MASK,
+                                                                        (from >> Z_SHIFT & XZ_MASK) % CHUNK_DEPTH});
+            }
+
+        private:
+            LightWindow(const glm::ivec2 &minChunk, const glm::ivec2 &maxChunk, bool queueBorders)
+                : m_origin(minChunk - glm::ivec2(WINDOW_MARGIN)),
+                  m_size(maxChunk - minChunk + glm::ivec2(1 + 2 * WINDOW_MARGIN)),
+                  m_queueBorders(queueBorders),
+                  m_steps(BASE_STEPS),
+                  m_chunks(t_windowChunks)
+            {
+                m_steps[POS_X].edge = static_cast<uint32_t>(m_size.x) * CHUNK_WIDTH - 1;
+                m_steps[POS_Z].edge = static_cast<uint32_t>(m_size.y) * CHUNK_DEPTH - 1;
+                m_chunks.assign(static_cast<size_t>(m_size.x) * m_size.y, nullptr);
+            }
+
+            glm::ivec2 m_origin; // chunk coordinates of the window's first chunk
+            glm::ivec2 m_size;   // in chunks
+            bool m_queueBorders;
+            std::vector<LightWrite> *m_writes = nullptr;
+            Steps m_steps;
+            std::vector<Chunk *> &m_chunks;
+        };
+
+        // Reused by every fill on the thread; each fill clears what it uses first.
+        // Border exchange runs both channels from the same seeds, hence two fill queues.
+        thread_local LightQueue t_fillQueue;
+        thread_local LightQueue t_blockFillQueue;
+        thread_local LightQueue t_removalQueue;
+
+        // The two channels share their fills. Sky light also travels straight down at
+        // full strength; block light has sources that keep their own emission.
+        template <bool Sky>
+        uint8_t light_of(const BlockRef &ref)
+        {
+            if constexpr (Sky)
+                return ref.chunk->sky_light(ref.index);
+            else
+                return ref.chunk->block_light(ref.index);
+        }
+
+        template <bool Sky>
+        SectionLight &section_light(Chunk &chunk, size_t section)
+        {
+            if constexpr (Sky)
+                return chunk.sky_section(section);
+            else
+                return chunk.block_section(section);
+        }
+
+        // Every light write of the fills goes through here, so the incremental ones
+        // can be replayed. `old_light` is the block's light, which callers have at hand.
+        template <bool Sky>
+        void set_light(const LightWindow &window, uint32_t voxel, const BlockRef &ref, uint8_t old_light, uint8_t light)
+        {
+            if (std::vector<LightWrite> *writes = window.writes())
+            {
+                writes->push_back({voxel, static_cast<uint16_t>(ref.index), old_light, light <= old_light});
+            }
+            if constexpr (Sky)
+                ref.chunk->set_sky_light(ref.index, light);
+            else
+                ref.chunk->set_block_light(ref.index, light);
+        }
+
+        // Spreads light outwards from every queued voxel until nothing brightens any more.
+        template <bool Sky>
+        void run_fill(const LightWindow &window, LightQueue &queue)
+        {
+            const Steps &steps = window.steps();
+            while (!queue.empty())
+            {
+                uint32_t voxel = queue.pop();
+                uint8_t light = light_of<Sky>(window.at(voxel));
+                if (light <= 1)
+                {
+                    continue; // Too dim to reach anything, or darkened since it was queued.
+                }
+
+                for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+                {
+                    const Step &step = steps[direction];
+                    if (!can_step(voxel, step))
+                    {
+                        continue;
+                    }
+
+                    uint8_t spread = (Sky && direction == NEG_Y && light == MAX_LIGHT) ? MAX_LIGHT : light - 1;
+                    uint32_t neighbor = voxel + step.delta;
+                    BlockRef neighbor_ref = window.at(neighbor);
+                    if (!neighbor_ref)
+                    {
+                        window.queue_for_unloaded_neighbor(voxel, direction);
+                    }
+                    else if (neighbor_ref.block().isTransparent())
+                    {
+                        uint8_t neighbor_light = light_of<Sky>(neighbor_ref);
+                        if (neighbor_light < spread)
+                        {
+                            set_light<Sky>(window, neighbor, neighbor_ref, neighbor_light, spread);
+                            queue.push(neighbor);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Raises `voxel` to what its neighbours (and, for block light, its own
+        // emission) give it and queues it to spread from there.
+        template <bool Sky>
+        void pull_light(const LightWindow &window, uint32_t voxel, LightQueue &queue)
         {
-            for (int y = 0; y < CHUNK_HEIGHT; ++y)
+            const Steps &steps = window.steps();
+            BlockRef ref = window.at(voxel);
+            const Block &block = ref.block();
+            uint8_t max_light = Sky ? 0 : block.emission();
+            if (block.isTransparent())
             {
-                for (int z = 0; z < CHUNK_DEPTH; ++z)
+                // The top of the world is open to the sky.
+                if (Sky && (voxel & Y_MASK) == CHUNK_HEIGHT - 1)
                 {
-                    chunk->getBlock(x, y, z)->sky_light = 0;
+                    max_light = MAX_LIGHT;
+                }
+
+                for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+                {
+                    const Step &step = steps[direction];
+                    if (!can_step(voxel, step))
+                    {
+                        continue;
+                    }
+                    BlockRef neighbor_ref = window.at(voxel + step.delta);
+                    uint8_t neighbor_light = neighbor_ref ? light_of<Sky>(neighbor_ref) : 0;
+                    if (neighbor_light > 0)
+                    {
+                        uint8_t potential_light = (Sky && direction == POS_Y && neighbor_light == MAX_LIGHT) ? MAX_LIGHT : neighbor_light - 1;
+                        max_light = std::max(max_light, potential_light);
+                    }
                 }
             }
+
+            uint8_t light = light_of<Sky>(ref);
+            if (light < max_light)
+            {
+                set_light<Sky>(window, voxel, ref, light, max_light);
+                queue.push(voxel);
+            }
         }
 
-        std::queue<glm::ivec3> light_queue;
+        // Starts taking away the light `light_level` that `voxel` had.
+        template <bool Sky>
+        void queue_removal(const LightWindow &window, uint32_t voxel, uint8_t light_level, LightQueue &removal)
+        {
+            BlockRef ref = window.at(voxel);
+            set_light<Sky>(window, voxel, ref, light_of<Sky>(ref), 0);
+            if (light_level > 0)
+            {
+                removal.push(voxel | static_cast<uint32_t>(light_level) << LIGHT_SHIFT);
+            }
+        }
 
-        // Phase 1: Vertical Sky Light Pass & Optimized Queue Seeding
-        for (int x = 0; x < CHUNK_WIDTH; ++x)
+        // Darkens every block that was lit through the queued removals, then
+        // refills them from the brighter blocks around the darkened area and from
+        // any light source caught inside it. Several removals can share one pass.
+        template <bool Sky>
+        void run_removal(const LightWindow &window, LightQueue &removal, LightQueue &relight)
         {
-            for (int z = 0; z < CHUNK_DEPTH; ++z)
+            const Steps &steps = window.steps();
+            while (!removal.empty())
             {
-                for (int y = CHUNK_HEIGHT - 1; y >= 0; --y)
+                uint32_t entry = removal.pop();
+                uint32_t pos = entry & VOXEL_MASK;
+                uint8_t light = static_cast<uint8_t>(entry >> LIGHT_SHIFT);
+
+                for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
                 {
-                    Block *block = chunk->getBlock(x, y, z);
-                    if (block && block->isTransparent())
+                    const Step &step = steps[direction];
+                    if (!can_step(pos, step))
+                    {
+                        continue;
+                    }
+                    uint32_t neighbor = pos + step.delta;
+                    BlockRef neighbor_ref = window.at(neighbor);
+                    if (!neighbor_ref)
+                    {
+                        continue;
+                    }
+
+                    uint8_t neighbor_light = light_of<Sky>(neighbor_ref);
+                    // Full sky light right below came straight down through here.
+                    bool lit_from_here = neighbor_light != 0 &&
+                                         (neighbor_light < light || (Sky && direction == NEG_Y && light == MAX_LIGHT));
+                    if (lit_from_here)
                     {
-                        block->sky_light = 15;
-                        light_queue.push({x, y, z});
+                        uint8_t emission = Sky ? 0 : neighbor_ref.block().emission();
+                        set_light<Sky>(window, neighbor, neighbor_ref, neighbor_light, emission);
+                        if (emission > 0)
+                        {
+                            relight.push(neighbor);
+                        }
+                        removal.push(neighbor | static_cast<uint32_t>(neighbor_light) << LIGHT_SHIFT);
                     }
-                    else
+                    else if (neighbor_light >= light)
                     {
-                        break;
+                        relight.push(neighbor);
                     }
                 }
             }
+
+            run_fill<Sky>(window, relight);
         }
 
-        // Phase 2: Propagation Flood Fill
-        while (!light_queue.empty())
+        template <bool Sky>
+        void add_light(World *world, int x, int y, int z)
         {
-            glm::ivec3 pos = light_queue.front();
-            light_queue.pop();
+            glm::ivec2 chunkPos = World::chunk_coords_for(x, z);
+            LightWindow window(world, chunkPos, chunkPos);
+            uint32_t voxel = window.pack(x, y, z);
+            if (!window.at(voxel))
+            {
+                return;
+            }
 
-            uint8_t current_light_level = chunk->getBlock(pos.x, pos.y, pos.z)->sky_light;
+            LightQueue &queue = t_fillQueue;
+            queue.clear();
+            pull_light<Sky>(window, voxel, queue);
+            run_fill<Sky>(window, queue);
+        }
 
-            const glm::ivec3 neighbors[6] = {
-                pos + glm::ivec3(-1, 0, 0),
-                pos + glm::ivec3(1, 0, 0),
-                pos + glm::ivec3(0, -1, 0),
-                pos + glm::ivec3(0, 1, 0),
-                pos + glm::ivec3(0, 0, -1),
-                pos + glm::ivec3(0, 0, 1)};
+        template <bool Sky>
+        void remove_light(World *world, int x, int y, int z, uint8_t light_level)
+        {
+            glm::ivec2 chunkPos = World::chunk_coords_for(x, z);
+            LightWindow window(world, chunkPos, chunkPos);
+            uint32_t voxel = window.pack(x, y, z);
+            if (light_level == 0 || !window.at(voxel))
+            {
+                return;
+            }
+
+            LightQueue &removal = t_removalQueue;
+            LightQueue &relight = t_fillQueue;
+            removal.clear();
+            relight.clear();
+            queue_removal<Sky>(window, voxel, light_level, removal);
+            run_removal<Sky>(window, removal, relight);
+        }
+
+        // Turns the writes recorded during one channel's pass into the blocks whose
+        // light really changed. A pass darkens before it refills, so a darkened
+        // block's first write holds its light from before the pass; it changed if
+        // its light now differs, since it may have been refilled to what it had. A
+        // block only ever raised is brighter than before. The sections written to
+        // are compacted, as light refilled after a removal often ends up uniform again.
+        template <bool Sky>
+        void collect_changed_light(const LightWindow &window, LightDirtyRegions &changed)
+        {
+            std::vector<LightWrite> &writes = t_lightWrites;
+
+            // Boxes are grown per chunk of the window, then handed over once each.
+            std::vector<BlockBox> &boxes = t_changedBoxes;
+            std::vector<uint8_t> &has_box = t_changedBoxFlags;
+            std::vector<uint8_t> &written_sections = t_writtenSections;
+            has_box.assign(window.slot_count(), 0);
+            written_sections.assign(window.slot_count(), 0);
+            boxes.resize(window.slot_count());
+            auto include = [&](uint32_t voxel)
+            {
+                glm::ivec3 position = window.position(voxel);
+                size_t slot = window.slot(voxel);
+                if (has_box[slot])
+                {
+                    boxes[slot].include({position, position});
+                }
+                else
+                {
+                    boxes[slot] = {position, position};
+                    has_box[slot] = 1;
+                }
+            };
 
-            for (const auto &neighbor : neighbors)
+            // Darkened blocks are looked up by their slot's run of CHUNK_VOLUME bits.
+            std::vector<uint64_t> &darkened = t_darkenedBlocks;
+            if (darkened.size() < window.slot_count() * CHUNK_VOLUME / 64)
             {
-                uint8_t light_level_to_propagate = (neighbor.y < pos.y && current_light_level == 15) ? 15 : (current_light_level > 0 ? current_light_level - 1 : 0);
+                darkened.resize(window.slot_count() * CHUNK_VOLUME / 64, 0);
+            }
+            auto darkened_bit = [&](const LightWrite &write)
+            {
+                return window.slot(write.voxel) * CHUNK_VOLUME + write.index;
+            };
 
-                if (light_level_to_propagate == 0)
+            for (const LightWrite &write : writes)
+            {
+                written_sections[window.slot(write.voxel)] |= static_cast<uint8_t>(1u << Chunk::section_of(write.index));
+                if (!write.darkens)
                 {
                     continue;
                 }
+                size_t bit = darkened_bit(write);
+                uint64_t mask = uint64_t{1} << (bit % 64);
+                if (!(darkened[bit / 64] & mask))
+                {
+                    if (light_of<Sky>(BlockRef{window.chunk(write.voxel), write.index}) != write.old_light)
+                    {
+                        include(write.voxel);
+                    }
+                    darkened[bit / 64] |= mask;
+                }
+            }
+            for (const LightWrite &write : writes)
+            {
+                if (write.darkens)
+                {
+                    continue;
+                }
+                size_t bit = darkened_bit(write);
+                if (!(darkened[bit / 64] & uint64_t{1} << (bit % 64)))
+                {
+                    include(write.voxel);
+                }
+            }
+            for (const LightWrite &write : writes)
+            {
+                if (write.darkens)
+                {
+                    size_t bit = darkened_bit(write);
+                    darkened[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+                }
+            }
 
-                Block *neighbor_block = world->getBlock(neighbor.x, neighbor.y, neighbor.z);
-                if (neighbor_block && neighbor_block->isTransparent() && neighbor_block->sky_light < light_level_to_propagate)
+            for (size_t slot = 0; slot < has_box.size(); ++slot)
+            {
+                if (has_box[slot])
+                {
+                    include_light_dirty(changed, window.slot_chunk(slot), boxes[slot]);
+                }
+                for (size_t section = 0; section < SECTION_COUNT; ++section)
                 {
-                    neighbor_block->sky_light = light_level_to_propagate;
-                    light_queue.push(neighbor);
+                    if (written_sections[slot] >> section & 1)
+                    {
+                        section_light<Sky>(*window.chunk_in_slot(slot), section).compact();
+                    }
                 }
             }
+            writes.clear();
         }
-    }
 
-    void Light::run_light_propagation_queue(World *world, std::queue<glm::ivec3> &queue)
-    {
-        while (!queue.empty())
+        // Resolves one channel for a batch of block changes that all lie in `window`.
+        template <bool Sky>
+        void apply_channel(const LightWindow &window, const std::vector<BlockChange> &changes, LightDirtyRegions &changed)
         {
-            glm::ivec3 pos = queue.front();
-            queue.pop();
+            t_lightWrites.clear();
 
-            uint8_t current_light_level = world->getBlock(pos.x, pos.y, pos.z)->sky_light;
+            LightQueue &removal = t_removalQueue;
+            LightQueue &queue = t_fillQueue;
+            removal.clear();
+            queue.clear();
 
-            const glm::ivec3 neighbors[6] = {
-                pos + glm::ivec3(-1, 0, 0),
-                pos + glm::ivec3(1, 0, 0),
-                pos + glm::ivec3(0, -1, 0),
-                pos + glm::ivec3(0, 1, 0),
-                pos + glm::ivec3(0, 0, -1),
-                pos + glm::ivec3(0, 0, 1)};
+            // Takes away the light every changed block stopped letting through or giving off...
+            for (const BlockChange &change : changes)
+            {
+                uint32_t voxel = window.pack(change.position.x, change.position.y, change.position.z);
+                const Block &block = window.at(voxel).block();
+                bool now_blocks = change.was_transparent && !block.isTransparent();
+                if (Sky ? now_blocks : (now_blocks || change.emission > 0))
+                {
+                    queue_removal<Sky>(window, voxel, Sky ? change.sky_light : change.block_light, removal);
+                }
+            }
+            run_removal<Sky>(window, removal, queue);
 
-            for (const auto &neighbor : neighbors)
+            // ...then lets it in where blocks opened up or started to shine.
+            queue.clear();
+            for (const BlockChange &change : changes)
             {
-                uint8_t light_level_to_propagate = (neighbor.y < pos.y && current_light_level == 15) ? 15 : (current_light_level > 0 ? current_light_level - 1 : 0);
+                uint32_t voxel = window.pack(change.position.x, change.position.y, change.position.z);
+                const Block &block = window.at(voxel).block();
+                bool now_passes = !change.was_transparent && block.isTransparent();
+                if (now_passes || (!Sky && block.emission() > 0))
+                {
+                    pull_light<Sky>(window, voxel, queue);
+                }
+            }
+            run_fill<Sky>(window, queue);
+
+            collect_changed_light<Sky>(window, changed);
+        }
 
-                if (light_level_to_propagate == 0)
+        // Offers the chunk's lit border blocks on `side` to the neighbour there,
+        // replacing whatever it had queued for that side before.
+        void queue_lit_border(Chunk *chunk, int side)
+        {
+            chunk->take_border_light(side);
+            for (int y = 0; y < static_cast<int>(CHUNK_HEIGHT); ++y)
+            {
+                // Where both channels are a single value for the whole section,
+                // its border blocks are all lit or all too dim.
+                const SectionLight &sky = chunk->sky_section(y / SECTION_HEIGHT);
+                const SectionLight &block = chunk->block_section(y / SECTION_HEIGHT);
+                const bool uniform = sky.is_uniform() && block.is_uniform();
+                const bool uniform_lit = std::max(sky.uniform_light(), block.uniform_light()) >= MIN_LIGHT_TO_CROSS_BORDER;
+                for (int i = 0; i < static_cast<int>(CHUNK_WIDTH); ++i)
                 {
-                    continue;
+                    const glm::ivec3 borders[CHUNK_SIDE_COUNT] = {
+                        {0, y, i},
+                        {static_cast<int>(CHUNK_WIDTH) - 1, y, i},
+                        {i, y, 0},
+                        {i, y, static_cast<int>(CHUNK_DEPTH) - 1}};
+                    const glm::ivec3 &local = borders[side];
+                    size_t index = local.x * BLOCK_STRIDE_X + local.y * BLOCK_STRIDE_Y + local.z;
+                    if (uniform ? uniform_lit : std::max(chunk->sky_light(index), chunk->block_light(index)) >= MIN_LIGHT_TO_CROSS_BORDER)
+                    {
+                        chunk->queue_border_light(side, local);
+                    }
+                }
+            }
+        }
+
+        void queue_lit_borders(Chunk *chunk)
+        {
+            for (int side = 0; side < CHUNK_SIDE_COUNT; ++side)
+            {
+                queue_lit_border(chunk, side);
+            }
+        }
+
+#if defined(FLINT_LIGHT_SLABS_SSE2) || defined(FLINT_LIGHT_SLABS_NEON)
+        // The slab kernel keeps a chunk as 16x16 layers, one per y, with each row
+        // of 16 blocks along z in one vector register: a byte of light per block.
+        static_assert(CHUNK_DEPTH == 16, "a layer row must fill one 16-byte vector");
+        using Slab = uint8_t[CHUNK_HEIGHT][CHUNK_WIDTH][CHUNK_DEPTH];
+
+#if defined(FLINT_LIGHT_SLABS_SSE2)
+        using Row = __m128i;
+        Row load_row(const uint8_t *bytes) { return _mm_load_si128(reinterpret_cast<const __m128i *>(bytes)); }
+        void store_row(uint8_t *bytes, Row row) { _mm_store_si128(reinterpret_cast<__m128i *>(bytes), row); }
+        Row splat(uint8_t value) { return _mm_set1_epi8(static_cast<char>(value)); }
+        Row max_row(Row a, Row b) { return _mm_max_epu8(a, b); }
+        Row dim_row(Row row) { return _mm_subs_epu8(row, _mm_set1_epi8(1)); }
+        Row and_row(Row a, Row b) { return _mm_and_si128(a, b); }
+        Row equal_row(Row a, Row b) { return _mm_cmpeq_epi8(a, b); }
+        bool same_row(Row a, Row b) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF; }
+        // Every block's neighbour towards -z, or towards +z; 0 past the chunk's edge.
+        Row from_neg_z(Row row) { return _mm_slli_si128(row, 1); }
+        Row from_pos_z(Row row) { return _mm_srli_si128(row, 1); }
+#else
+        using Row = uint8x16_t;
+        Row load_row(const uint8_t *bytes) { return vld1q_u8(bytes); }
+        void store_row(uint8_t *bytes, Row row) { vst1q_u8(bytes, row); }
+        Row splat(uint8_t value) { return vdupq_n_u8(value); }
+        Row max_row(Row a, Row b) { return vmaxq_u8(a, b); }
+        Row dim_row(Row row) { return vqsubq_u8(row, vdupq_n_u8(1)); }
+        Row and_row(Row a, Row b) { return vandq_u8(a, b); }
+        Row equal_row(Row a, Row b) { return vceqq_u8(a, b); }
+        bool same_row(Row a, Row b) { return vminvq_u8(vceqq_u8(a, b)) == 0xFF; }
+        Row from_neg_z(Row row) { return vextq_u8(vdupq_n_u8(0), row, 15); }
+        Row from_pos_z(Row row) { return vextq_u8(row, vdupq_n_u8(0), 1); }
+#endif
+
+        // Raises layer `y` to what the layers above and below give it, then spreads
+        // the light sideways within the layer until it settles. `open` is 0xFF for
+        // transparent blocks and 0 for opaque ones. Returns whether the layer brightened.
+        bool relax_layer(Slab &light, const Slab &open, int y)
+        {
+            const Row full = splat(MAX_LIGHT);
+            Row rows[CHUNK_WIDTH];
+            Row masks[CHUNK_WIDTH];
+            bool brightened = false;
+
+            for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+            {
+                // The top of the world is open to the sky, and full sky light goes
+                // straight down undimmed.
+                Row above = y + 1 < static_cast<int>(CHUNK_HEIGHT) ? load_row(light[y + 1][x]) : full;
+                Row from_above = max_row(dim_row(above), and_row(equal_row(above, full), full));
+                Row from_below = y > 0 ? dim_row(load_row(light[y - 1][x])) : splat(0);
+
+                Row row = load_row(light[y][x]);
+                masks[x] = load_row(open[y][x]);
+                rows[x] = max_row(row, and_row(max_row(from_above, from_below), masks[x]));
+                brightened |= !same_row(rows[x], row);
+            }
+
+            auto spread = [&](size_t x)
+            {
+                Row around = max_row(from_neg_z(rows[x]), from_pos_z(rows[x]));
+                if (x > 0)
+                {
+                    around = max_row(around, rows[x - 1]);
+                }
+                if (x + 1 < CHUNK_WIDTH)
+                {
+                    around = max_row(around, rows[x + 1]);
                 }
+                Row next = max_row(rows[x], and_row(dim_row(around), masks[x]));
+                bool moved = !same_row(next, rows[x]);
+                rows[x] = next;
+                return moved;
+            };
 
-                Block *neighbor_block = world->getBlock(neighbor.x, neighbor.y, neighbor.z);
-                if (neighbor_block && neighbor_block->isTransparent() && neighbor_block->sky_light < light_level_to_propagate)
+            // Forward and back over x, so light crosses the layer along x in one round.
+            bool spreading = true;
+            while (spreading)
+            {
+                spreading = false;
+                for (size_t x = 0; x < CHUNK_WIDTH; ++x)
                 {
-                    neighbor_block->sky_light = light_level_to_propagate;
-                    queue.push(neighbor);
+                    spreading |= spread(x);
                 }
+                for (size_t x = CHUNK_WIDTH; x-- > 0;)
+                {
+                    spreading |= spread(x);
+                }
+                brightened |= spreading;
             }
+
+            for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+            {
+                store_row(light[y][x], rows[x]);
+            }
+            return brightened;
         }
-    }
+#endif
+    } // namespace
 
-    void Light::propagate_light_addition(World *world, int x, int y, int z)
+    void Light::calculate_sky_light(Chunk *chunk)
     {
-        std::queue<glm::ivec3> light_queue;
+        const Block *blocks = chunk->blocks();
+        LightWindow window(chunk);
+        const uint32_t origin = window.pack(chunk->getChunkX() * static_cast<int>(CHUNK_WIDTH), 0, chunk->getChunkZ() * static_cast<int>(CHUNK_DEPTH));
+        LightQueue &light_queue = t_fillQueue;
+        light_queue.clear();
+
+        // Phase 0: Find where each column's sky light stops, at its top-most opaque block
+        std::array<int, CHUNK_WIDTH * CHUNK_DEPTH> floors;
+        int lowest_floor = CHUNK_HEIGHT;
+        int highest_floor = 0;
+        for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+        {
+            for (size_t z = 0; z < CHUNK_DEPTH; ++z)
+            {
+                int y = CHUNK_HEIGHT;
+                while (y > 0 && blocks[x * BLOCK_STRIDE_X + (y - 1) * BLOCK_STRIDE_Y + z].isTransparent())
+                {
+                    --y;
+                }
+                floors[x * CHUNK_DEPTH + z] = y;
+                lowest_floor = std::min(lowest_floor, y);
+                highest_floor = std::max(highest_floor, y);
+            }
+        }
 
-        uint8_t max_light = 0;
-        const glm::ivec3 neighbors[6] = {
-            {x - 1, y, z},
-            {x + 1, y, z},
-            {x, y - 1, z},
-            {x, y + 1, z},
-            {x, y, z - 1},
-            {x, y, z + 1}};
+        // Phase 1: Vertical Sky Light Pass, a section at a time. Sections above
+        // every floor are open sky and those below every floor start dark; both
+        // stay a single value.
+        uint8_t section_light[SECTION_VOLUME];
+        for (size_t section = 0; section < SECTION_COUNT; ++section)
+        {
+            const int bottom = static_cast<int>(section * SECTION_HEIGHT);
+            if (bottom >= highest_floor || bottom + static_cast<int>(SECTION_HEIGHT) <= lowest_floor)
+            {
+                chunk->sky_section(section).fill(bottom >= highest_floor ? MAX_LIGHT : 0);
+                continue;
+            }
+            for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+            {
+                for (size_t y = 0; y < SECTION_HEIGHT; ++y)
+                {
+                    for (size_t z = 0; z < CHUNK_DEPTH; ++z)
+                    {
+                        bool open = bottom + static_cast<int>(y) >= floors[x * CHUNK_DEPTH + z];
+                        section_light[(x * SECTION_HEIGHT + y) * CHUNK_DEPTH + z] = open ? MAX_LIGHT : 0;
+                    }
+                }
+            }
+            chunk->sky_section(section).assign(section_light);
+        }
 
-        for (const auto &neighbor : neighbors)
+        // Optimized Queue Seeding: the sky columns are already full above and below,
+        // so only their blocks beside a still unlit transparent block can spread.
+        // That needs a neighbouring column whose floor is higher, which leaves
+        // the layers between the lowest and highest floor.
+        for (size_t x = 0; x < CHUNK_WIDTH; ++x)
         {
-            Block *neighbor_block = world->getBlock(neighbor.x, neighbor.y, neighbor.z);
-            if (neighbor_block)
+            for (int y = lowest_floor; y < highest_floor; ++y)
             {
-                if (neighbor_block->sky_light > 0)
+                for (size_t z = 0; z < CHUNK_DEPTH; ++z)
                 {
-                    uint8_t potential_light = (y < neighbor.y && neighbor_block->sky_light == 15) ? 15 : neighbor_block->sky_light - 1;
-                    max_light = std::max(max_light, potential_light);
+                    size_t index = x * BLOCK_STRIDE_X + y * BLOCK_STRIDE_Y + z;
+                    if (y < floors[x * CHUNK_DEPTH + z])
+                    {
+                        continue;
+                    }
+                    // Below its column's floor a block has no sky light yet.
+                    auto unlit = [&](size_t column, size_t neighbor)
+                    {
+                        return y < floors[column] && blocks[neighbor].isTransparent();
+                    };
+                    size_t column = x * CHUNK_DEPTH + z;
+                    if ((x > 0 && unlit(column - CHUNK_DEPTH, index - BLOCK_STRIDE_X)) ||
+                        (x + 1 < CHUNK_WIDTH && unlit(column + CHUNK_DEPTH, index + BLOCK_STRIDE_X)) ||
+                        (z > 0 && unlit(column - 1, index - 1)) ||
+                        (z + 1 < CHUNK_DEPTH && unlit(column + 1, index + 1)))
+                    {
+                        light_queue.push(origin + static_cast<uint32_t>(x << X_SHIFT | z << Z_SHIFT | y));
+                    }
                 }
             }
         }
 
-        Block *block = world->getBlock(x, y, z);
-        if (block && block->sky_light < max_light)
+        // Phase 2: Propagation Flood Fill
+        run_fill<true>(window, light_queue);
+        for (size_t section = 0; section < SECTION_COUNT; ++section)
         {
-            block->sky_light = max_light;
-            light_queue.push({x, y, z});
+            chunk->sky_section(section).compact();
         }
 
-        run_light_propagation_queue(world, light_queue);
+        // Phase 3: Offer the lit border blocks to the neighbours
+        queue_lit_borders(chunk);
     }
 
-    void Light::propagate_light_removal(World *world, int x, int y, int z, uint8_t light_level)
+    void Light::calculate_sky_light_slabs(Chunk *chunk)
     {
-        if (light_level == 0)
+#if defined(FLINT_LIGHT_SLABS_SSE2) || defined(FLINT_LIGHT_SLABS_NEON)
+        const Block *blocks = chunk->blocks();
+        alignas(16) Slab light = {};
+        alignas(16) Slab open;
+        for (size_t x = 0; x < CHUNK_WIDTH; ++x)
         {
-            return; // Optimization: No light to remove.
+            for (size_t y = 0; y < CHUNK_HEIGHT; ++y)
+            {
+                for (size_t z = 0; z < CHUNK_DEPTH; ++z)
+                {
+                    open[y][x][z] = blocks[x * BLOCK_STRIDE_X + y * BLOCK_STRIDE_Y + z].isTransparent() ? 0xFF : 0;
+                }
+            }
         }
 
-        std::queue<std::pair<glm::ivec3, uint8_t>> removal_queue;
-        removal_queue.push({{x, y, z}, light_level});
+        // Light only ever grows towards the flood fill's result, so sweeping down
+        // and back up until no layer has anything new to take from its neighbours
+        // reaches exactly it. A layer that brightened is settled within itself;
+        // only the layers above and below it need another look.
+        std::array<bool, CHUNK_HEIGHT> pending;
+        pending.fill(true);
+        auto relax = [&](int y)
+        {
+            if (!pending[y])
+            {
+                return;
+            }
+            pending[y] = false;
+            if (relax_layer(light, open, y))
+            {
+                if (y > 0)
+                    pending[y - 1] = true;
+                if (y + 1 < static_cast<int>(CHUNK_HEIGHT))
+                    pending[y + 1] = true;
+            }
+        };
+        while (std::find(pending.begin(), pending.end(), true) != pending.end())
+        {
+            for (int y = CHUNK_HEIGHT - 1; y >= 0; --y)
+            {
+                relax(y);
+            }
+            for (int y = 0; y < static_cast<int>(CHUNK_HEIGHT); ++y)
+            {
+                relax(y);
+            }
+        }
 
-        std::queue<glm::ivec3> relight_queue;
+        // Rows along z are whole in both layouts; each section takes its rows at once.
+        alignas(16) uint8_t section_light[SECTION_VOLUME];
+        for (size_t section = 0; section < SECTION_COUNT; ++section)
+        {
+            for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+            {
+                for (size_t y = 0; y < SECTION_HEIGHT; ++y)
+                {
+                    std::memcpy(&section_light[(x * SECTION_HEIGHT + y) * CHUNK_DEPTH], light[section * SECTION_HEIGHT + y][x], CHUNK_DEPTH);
+                }
+            }
+            chunk->sky_section(section).assign(section_light);
+        }
+        queue_lit_borders(chunk);
+#else
+        calculate_sky_light(chunk);
+#endif
+    }
 
-        while (!removal_queue.empty())
+    void Light::exchange_border_light(World *world, const glm::ivec2 &chunkPos)
+    {
+        Chunk *chunk = world->getChunk(chunkPos.x, chunkPos.y);
+        if (!chunk)
         {
-            auto [pos, light] = removal_queue.front();
-            removal_queue.pop();
+            return;
+        }
 
-            const glm::ivec3 neighbors[6] = {
-                pos + glm::ivec3(-1, 0, 0),
-                pos + glm::ivec3(1, 0, 0),
-                pos + glm::ivec3(0, -1, 0),
-                pos + glm::ivec3(0, 1, 0),
-                pos + glm::ivec3(0, 0, -1),
-                pos + glm::ivec3(0, 0, 1)};
+        // Border blocks from both sides of every loaded neighbour seed one flood fill
+        // per channel. Light only ever grows here, so the order of the seeds does not matter.
+        LightWindow window(world, chunkPos, chunkPos);
+        LightQueue &sky_queue = t_fillQueue;
+        LightQueue &block_queue = t_blockFillQueue;
+        sky_queue.clear();
+        block_queue.clear();
+        auto seed = [&](const Chunk &from, const std::vector<glm::ivec3> &locals)
+        {
+            glm::ivec3 origin(from.getChunkX() * static_cast<int>(CHUNK_WIDTH), 0, from.getChunkZ() * static_cast<int>(CHUNK_DEPTH));
+            for (const glm::ivec3 &local : locals)
+            {
+                uint32_t voxel = window.pack(origin.x + local.x, local.y, origin.z + local.z);
+                sky_queue.push(voxel);
+                block_queue.push(voxel);
+            }
+        };
 
-            for (const auto &neighbor : neighbors)
+        for (int side = 0; side < CHUNK_SIDE_COUNT; ++side)
+        {
+            glm::ivec2 neighborPos = chunkPos + SIDE_OFFSETS[side];
+            Chunk *neighbor = world->getChunk(neighborPos.x, neighborPos.y);
+            if (!neighbor)
             {
-                Block *neighbor_block = world->getBlock(neighbor.x, neighbor.y, neighbor.z);
-                if (neighbor_block)
+                continue; // Our queue for this side waits for the neighbour to load.
+            }
+            seed(*chunk, chunk->take_border_light(side));
+            seed(*neighbor, neighbor->take_border_light(side ^ 1));
+        }
+
+        run_fill<true>(window, sky_queue);
+        run_fill<false>(window, block_queue);
+    }
+
+    void Light::propagate_light_addition(World *world, int x, int y, int z)
+    {
+        add_light<true>(world, x, y, z);
+    }
+
+    void Light::propagate_light_removal(World *world, int x, int y, int z, uint8_t light_level)
+    {
+        remove_light<true>(world, x, y, z, light_level);
+    }
+
+    void Light::requeue_border_light(Chunk *chunk, int side)
+    {
+        queue_lit_border(chunk, side);
+    }
+
+    void Light::calculate_block_light(Chunk *chunk)
+    {
+        const Block *blocks = chunk->blocks();
+        LightWindow window(chunk);
+        const uint32_t origin = window.pack(chunk->getChunkX() * static_cast<int>(CHUNK_WIDTH), 0, chunk->getChunkZ() * static_cast<int>(CHUNK_DEPTH));
+        LightQueue &light_queue = t_fillQueue;
+        light_queue.clear();
+
+        for (size_t section = 0; section < SECTION_COUNT; ++section)
+        {
+            chunk->block_section(section).fill(0);
+        }
+        for (size_t x = 0; x < CHUNK_WIDTH; ++x)
+        {
+            for (size_t y = 0; y < CHUNK_HEIGHT; ++y)
+            {
+                for (size_t z = 0; z < CHUNK_DEPTH; ++z)
                 {
-                    uint8_t neighbor_light = neighbor_block->sky_light;
-                    if (neighbor_light != 0 && neighbor_light < light)
-                    {
-                        neighbor_block->sky_light = 0;
-                        removal_queue.push({neighbor, neighbor_light});
-                    }
-                    else if (neighbor_light >= light)
+                    size_t index = x * BLOCK_STRIDE_X + y * BLOCK_STRIDE_Y + z;
+                    uint8_t emission = blocks[index].emission();
+                    if (emission > 0)
                     {
-                        relight_queue.push(neighbor);
+                        chunk->set_block_light(index, emission);
+                        light_queue.push(origin + static_cast<uint32_t>(x << X_SHIFT | z << Z_SHIFT | y));
                     }
                 }
             }
         }
 
-        run_light_propagation_queue(world, relight_queue);
+        // Most chunks have no light sources at all, and keep no block light nibbles.
+        if (!light_queue.empty())
+        {
+            run_fill<false>(window, light_queue);
+        }
+    }
+
+    void Light::propagate_block_light_addition(World *world, int x, int y, int z)
+    {
+        add_light<false>(world, x, y, z);
+    }
+
+    void Light::propagate_block_light_removal(World *world, int x, int y, int z, uint8_t light_level)
+    {
+        remove_light<false>(world, x, y, z, light_level);
+    }
+
+    void Light::apply_block_changes(World *world, const std::vector<BlockChange> &changes, LightDirtyRegions &changed)
+    {
+        if (changes.empty())
+        {
+            return;
+        }
+
+        glm::ivec2 minChunk = World::chunk_coords_for(changes.front().position.x, changes.front().position.z);
+        glm::ivec2 maxChunk = minChunk;
+        for (const BlockChange &change : changes)
+        {
+            glm::ivec2 chunkPos = World::chunk_coords_for(change.position.x, change.position.z);
+            minChunk = glm::min(minChunk, chunkPos);
+            maxChunk = glm::max(maxChunk, chunkPos);
+        }
+
+        // Changes spread further apart than one window can address are resolved
+        // one by one. Each still sees the others' blocks and a removal never
+        // leaves light behind, so the result is the same, only slower.
+        if (!LightWindow::fits(minChunk, maxChunk) && changes.size() > 1)
+        {
+            for (const BlockChange &change : changes)
+            {
+                apply_block_changes(world, {change}, changed);
+            }
+            return;
+        }
+
+        LightWindow window(world, minChunk, maxChunk);
+        window.record_writes();
+        apply_channel<true>(window, changes, changed);
+        apply_channel<false>(window, changes, changed);
     }
 
-} // namespace flint
\ No newline at end of file
+} // namespace flint
@@ -1,20 +1,62 @@
 #pragma once
 
 #include "world.h"
-#include <queue>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace flint
 {
+    // Flood-fill lighting. The fills run on packed 32-bit voxel indices in
+    // reusable ring buffers (LightQueue), one set per thread, so lighting a
+    // chunk or an edit does not allocate once the queues have warmed up.
+    // Light is kept per chunk section (SectionLight): sections of open sky or
+    // solid ground are a single value, which whole-chunk lighting sets at once
+    // instead of flooding through them.
     class Light
     {
     public:
-        static void calculate_sky_light(World *world);
+        // Lights a freshly generated chunk in isolation, then queues its lit
+        // border blocks for the neighbours (Chunk::queue_border_light).
+        static void calculate_sky_light(Chunk *chunk);
+        // Gives exactly the same result as calculate_sky_light by another route:
+        // the chunk's 16x16 layers are relaxed whole with SIMD byte max and
+        // saturating subtract (`max(light, neighbour - 1)`, masked by opacity),
+        // sweeping down and up until nothing changes. Without SSE2 or NEON it is
+        // the flood fill.
+        static void calculate_sky_light_slabs(Chunk *chunk);
+        // Lets light flow across the borders between a loaded chunk and each of
+        // its loaded neighbours, from the border queues of both sides. Only the
+        // chunk and the chunks around it are touched; light heading into a
+        // chunk that is not loaded yet is queued on the border it would cross.
+        static void exchange_border_light(World *world, const glm::ivec2 &chunkPos);
+        // Queues the chunk's lit border blocks on `side` again, once the neighbour
+        // there is unloaded, so that light crosses over when it is loaded back.
+        static void requeue_border_light(Chunk *chunk, int side);
         static void propagate_light_addition(World *world, int x, int y, int z);
         static void propagate_light_removal(World *world, int x, int y, int z, uint8_t light_level);
 
-    private:
-        static void run_light_propagation_queue(World *world, std::queue<glm::ivec3> &queue);
+        // Block light from emissive blocks (Block::emission). It spreads like sky
+        // light minus the undimmed downward beam. Light sources are opaque: they
+        // hold their own emission and pass it on, but nothing flows through them.
+        //
+        // Floods the chunk's block light from the sources inside it, as
+        // calculate_sky_light does for the sky.
+        static void calculate_block_light(Chunk *chunk);
+        // Raises (x, y, z) to its own emission or to what its neighbours give it,
+        // then spreads from there. Only blocks within the new light's radius are visited.
+        static void propagate_block_light_addition(World *world, int x, int y, int z);
+        // Takes away the block light `light_level` that (x, y, z) had, darkening
+        // everything lit through it and refilling from the other sources in reach.
+        static void propagate_block_light_removal(World *world, int x, int y, int z, uint8_t light_level);
+
+        // Resolves a batch of block changes (see World::update_light) in one pass
+        // per channel: all the light the changed blocks took away is removed in a
+        // single flood, then everything they let in or give off is added in another.
+        // Overlapping changes share the work instead of relighting the same blocks
+        // once per change. Adds the blocks whose light ends up different to
+        // `changed`; blocks that were darkened and refilled to their old light
+        // do not count.
+        static void apply_block_changes(World *world, const std::vector<BlockChange> &changes, LightDirtyRegions &changed);
     };
 
-} // namespace flint
\ No newline at end of file
+} // namespace flint
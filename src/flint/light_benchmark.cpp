@@ -0,0 +1,223 @@
+#include "light_benchmark.h"
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+
+#include "benchmark_utils.h"
+#include "light.h"
+#include "world.h"
+
+namespace flint
+{
+    namespace
+    {
+        using bench::Clock;
+        using bench::EDIT_AREA;
+        using bench::EDIT_WORLD_RADIUS;
+        using bench::elapsed_ms;
+        using bench::percentile;
+        using bench::surface_height;
+
+        // The bulk edit: a cube of dirt in the air over the spawn area, straddling
+        // the corner of four chunks, filled and then cleared again.
+        constexpr int FILL_SIZE = 10;
+        const glm::ivec3 FILL_ORIGIN(-5, 18, -5);
+        constexpr uint32_t FILL_REPEATS = 20;
+    }
+
+    LightBenchmarkOptions LightBenchmarkOptions::from_args(int argc, char **argv)
+    {
+        LightBenchmarkOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--iterations" && hasValue)
+                options.iterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--output" && hasValue)
+                options.outputPath = argv[++i];
+        }
+        return options;
+    }
+
+    LightBenchmark::LightBenchmark(const LightBenchmarkOptions &options) : m_options(options)
+    {
+    }
+
+    void LightBenchmark::run()
+    {
+        std::cout << "Running light benchmark with " << m_options.iterations << " iterations..." << std::endl;
+
+        std::vector<Result> results;
+        // The spawn chunk has the tree and pillars; (3, 3) is open hills.
+        results.push_back(time_full_chunk(0, 0, false));
+        results.push_back(time_full_chunk(0, 0, true));
+        results.push_back(time_full_chunk(3, 3, false));
+        results.push_back(time_full_chunk(3, 3, true));
+        time_edits(results);
+        time_fill(results);
+
+        for (const Result &result : results)
+        {
+            std::cout << "  " << result.name << ": p50 " << percentile(result.ms, 0.50) << " ms, p95 " << percentile(result.ms, 0.95) << " ms" << std::endl;
+        }
+        write_report(results);
+    }
+
+    LightBenchmark::Result LightBenchmark::time_full_chunk(int chunk_x, int chunk_z, bool slabs) const
+    {
+        Result result{"full_chunk_" + std::to_string(chunk_x) + "_" + std::to_string(chunk_z) + (slabs ? "_slabs" : ""), {}};
+        result.ms.reserve(m_options.iterations);
+
+        Chunk chunk(chunk_x, chunk_z);
+        chunk.generateTerrain();
+        for (uint32_t i = 0; i < m_options.iterations; ++i)
+        {
+            Clock::time_point start = Clock::now();
+            Light::calculate_block_light(&chunk);
+            if (slabs)
+                Light::calculate_sky_light_slabs(&chunk);
+            else
+                Light::calculate_sky_light(&chunk);
+            result.ms.push_back(elapsed_ms(start, Clock::now()));
+        }
+
+        // The slab kernel is only a faster route to the same light.
+        if (slabs)
+        {
+            Chunk reference = chunk;
+            Light::calculate_sky_light(&reference);
+            for (size_t i = 0; i < CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH; ++i)
+            {
+                if (chunk.sky_light(i) != reference.sky_light(i))
+                {
+                    throw std::runtime_error("Slab sky light differs from the flood fill in chunk " + std::to_string(chunk_x) + ", " + std::to_string(chunk_z));
+                }
+            }
+        }
+        return result;
+    }
+
+    void LightBenchmark::time_edits(std::vector<Result> &results) const
+    {
+        World world;
+        world.load_chunks_around({0, 0}, EDIT_WORLD_RADIUS);
+
+        Result shadowPlace{"edit_place_shadow_block", {}};
+        Result shadowRemove{"edit_remove_shadow_block", {}};
+        Result lightPlace{"edit_place_light_source", {}};
+        Result lightRemove{"edit_remove_light_source", {}};
+
+        auto timed_set = [&world](Result &result, int x, int y, int z, BlockType type)
+        {
+            Clock::time_point start = Clock::now();
+            world.setBlock(x, y, z, type);
+            world.update_light();
+            result.ms.push_back(elapsed_ms(start, Clock::now()));
+        };
+
+        // A fixed sequence of columns, so runs are comparable.
+        bench::Random random(12345);
+
+        for (uint32_t i = 0; i < m_options.iterations; ++i)
+        {
+            int x = random.next(EDIT_AREA) - static_cast<int>(CHUNK_WIDTH);
+            int z = random.next(EDIT_AREA) - static_cast<int>(CHUNK_DEPTH);
+            int surface = surface_height(world, x, z);
+            if (surface < 0 || surface + 3 >= static_cast<int>(CHUNK_HEIGHT))
+            {
+                continue;
+            }
+
+            // A floating block shades the column below it and the ground around.
+            timed_set(shadowPlace, x, surface + 3, z, BlockType::Dirt);
+            timed_set(shadowRemove, x, surface + 3, z, BlockType::Air);
+
+            // A light source on the ground lights its full radius.
+            timed_set(lightPlace, x, surface + 1, z, BlockType::Glowstone);
+            timed_set(lightRemove, x, surface + 1, z, BlockType::Air);
+        }
+
+        results.push_back(std::move(shadowPlace));
+        results.push_back(std::move(shadowRemove));
+        results.push_back(std::move(lightPlace));
+        results.push_back(std::move(lightRemove));
+    }
+
+    void LightBenchmark::time_fill(std::vector<Result> &results) const
+    {
+        World world;
+        world.load_chunks_around({0, 0}, EDIT_WORLD_RADIUS);
+
+        const std::string size = std::to_string(FILL_SIZE) + "x" + std::to_string(FILL_SIZE) + "x" + std::to_string(FILL_SIZE);
+        Result fillPerBlock{"fill_" + size + "_per_block", {}};
+        Result fillBatched{"fill_" + size + "_batched", {}};
+        Result clearPerBlock{"clear_" + size + "_per_block", {}};
+        Result clearBatched{"clear_" + size + "_batched", {}};
+
+        // Relighting after every block is what setBlock used to do on its own.
+        auto fill = [&world](Result &result, BlockType type, bool perBlock)
+        {
+            Clock::time_point start = Clock::now();
+            for (int x = 0; x < FILL_SIZE; ++x)
+            {
+                for (int y = 0; y < FILL_SIZE; ++y)
+                {
+                    for (int z = 0; z < FILL_SIZE; ++z)
+                    {
+                        world.setBlock(FILL_ORIGIN.x + x, FILL_ORIGIN.y + y, FILL_ORIGIN.z + z, type);
+                        if (perBlock)
+                        {
+                            world.update_light();
+                        }
+                    }
+                }
+            }
+            world.update_light();
+            result.ms.push_back(elapsed_ms(start, Clock::now()));
+        };
+
+        for (uint32_t i = 0; i < FILL_REPEATS; ++i)
+        {
+            fill(fillPerBlock, BlockType::Dirt, true);
+            fill(clearPerBlock, BlockType::Air, true);
+            fill(fillBatched, BlockType::Dirt, false);
+            fill(clearBatched, BlockType::Air, false);
+        }
+
+        results.push_back(std::move(fillPerBlock));
+        results.push_back(std::move(fillBatched));
+        results.push_back(std::move(clearPerBlock));
+        results.push_back(std::move(clearBatched));
+    }
+
+    void LightBenchmark::write_report(const std::vector<Result> &results) const
+    {
+        std::ofstream out(m_options.outputPath);
+        if (!out)
+        {
+            throw std::runtime_error("Failed to open light benchmark output: " + m_options.outputPath);
+        }
+
+        out << "{\n";
+        out << "  \"iterations\": " << m_options.iterations << ",\n";
+        out << "  \"results\": {\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &result = results[i];
+            out << "    \"" << result.name << "\": {"
+                << "\"samples\": " << result.ms.size()
+                << ", \"ms_mean\": " << bench::mean(result.ms)
+                << ", \"ms_p50\": " << percentile(result.ms, 0.50)
+                << ", \"ms_p95\": " << percentile(result.ms, 0.95) << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  }\n";
+        out << "}\n";
+
+        std::cout << "Light benchmark report written to " << m_options.outputPath << std::endl;
+    }
+
+} // namespace flint
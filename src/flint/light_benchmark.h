@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flint
+{
+
+    struct LightBenchmarkOptions
+    {
+        // Full-chunk lighting runs, and place/remove pairs per kind of edit.
+        uint32_t iterations = 2000;
+        std::string outputPath = "light_benchmark.json";
+
+        // Parses `--iterations N --output PATH`.
+        static LightBenchmarkOptions from_args(int argc, char **argv);
+    };
+
+    // Times the light engine on the CPU, with no window or GPU involved:
+    // lighting whole chunks from scratch (by flood fill, and by the slab kernel
+    // checked against it), the incremental updates behind single block edits
+    // (a block casting a shadow, a light source placed and removed), and a
+    // 10x10x10 fill relit per block against relit as one batch. Writes the
+    // timings as JSON next to the frame benchmark's.
+    class LightBenchmark
+    {
+    public:
+        explicit LightBenchmark(const LightBenchmarkOptions &options);
+
+        void run();
+
+    private:
+        struct Result
+        {
+            std::string name;
+            std::vector<double> ms;
+        };
+
+        Result time_full_chunk(int chunk_x, int chunk_z, bool slabs) const;
+        void time_edits(std::vector<Result> &results) const;
+        void time_fill(std::vector<Result> &results) const;
+        void write_report(const std::vector<Result> &results) const;
+
+        LightBenchmarkOptions m_options;
+    };
+
+} // namespace flint
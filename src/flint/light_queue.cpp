@@ -0,0 +1,27 @@
+#include "light_queue.h"
+
+#include <bit>
+
+namespace flint
+{
+    LightQueue::LightQueue(size_t capacity)
+        : m_buffer(std::bit_ceil(capacity > 0 ? capacity : 1)), m_mask(m_buffer.size() - 1)
+    {
+    }
+
+    void LightQueue::grow()
+    {
+        // Unroll the ring into the front of the larger buffer.
+        std::vector<uint32_t> buffer(m_buffer.size() * 2);
+        const size_t count = size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffer[i] = m_buffer[(m_head + i) & m_mask];
+        }
+        m_buffer.swap(buffer);
+        m_mask = m_buffer.size() - 1;
+        m_head = 0;
+        m_tail = count;
+    }
+
+} // namespace flint
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flint
+{
+    // FIFO of packed 32-bit voxels for the light flood fills, on a ring buffer.
+    //
+    // The buffer doubles when it fills up and never shrinks, so a queue that is
+    // kept around (the light engine keeps one of each kind per thread) stops
+    // allocating once it has seen the largest fill.
+    class LightQueue
+    {
+    public:
+        explicit LightQueue(size_t capacity = 4096);
+
+        bool empty() const { return m_head == m_tail; }
+        size_t size() const { return m_tail - m_head; }
+
+        void push(uint32_t voxel)
+        {
+            if (size() == m_buffer.size())
+            {
+                grow();
+            }
+            m_buffer[m_tail++ & m_mask] = voxel;
+        }
+
+        uint32_t pop() { return m_buffer[m_head++ & m_mask]; }
+
+        void clear() { m_head = m_tail = 0; }
+
+    private:
+        void grow();
+
+        std::vector<uint32_t> m_buffer;
+        size_t m_mask;
+        size_t m_head = 0;
+        size_t m_tail = 0;
+    };
+
+} // namespace flint
@@ -93,7 +93,7 @@ namespace flint
                         new_block_pos.x,
                         new_block_pos.y,
                         new_block_pos.z,
-                        BlockType::Grass);
+                        m_place_block_type);
                     m_block_action_cooldown = BLOCK_ACTION_COOLDOWN_SECONDS;
                     return true;
                 }
@@ -124,6 +124,12 @@ namespace flint
                 case SDLK_SPACE:
                     movement_intention.jump = pressed;
                     break;
+                case SDLK_1:
+                    m_place_block_type = BlockType::Grass;
+                    break;
+                case SDLK_2:
+                    m_place_block_type = BlockType::Glowstone;
+                    break;
                 }
             }
         }
@@ -6,6 +6,7 @@
 #include <SDL3/SDL_events.h>
 #include <optional>
 
+#include "block.h"
 #include "physics.h"
 #include "raycast.h"
 
@@ -66,6 +67,9 @@ namespace flint
             // Cooldown for block placement/removal to prevent single-press multi-actions
             const float BLOCK_ACTION_COOLDOWN_SECONDS = 0.2f; // 200ms
             float m_block_action_cooldown = 0.0f;
+
+            // What a right click places; picked with the number keys.
+            BlockType m_place_block_type = BlockType::Grass;
         };
     }
 }
@@ -11,11 +11,11 @@ struct CameraUniform {
 @group(0) @binding(0)
 var<uniform> camera: CameraUniform;
 
-struct ModelUniform {
-    model: mat4x4<f32>,
+struct DrawUniform {
+    origin: vec4<f32>,
 };
 @group(0) @binding(1)
-var<uniform> model_uniform: ModelUniform;
+var<uniform> draw: DrawUniform;
 
 struct VertexInput {
     @location(0) position: vec3<f32>,
@@ -32,7 +32,7 @@ fn vs_main(
     model: VertexInput,
 ) -> VertexOutput {
     var out: VertexOutput;
-    out.clip_position = camera.view_proj * model_uniform.model * vec4<f32>(model.position, 1.0);
+    out.clip_position = camera.view_proj * vec4<f32>(model.position + draw.origin.xyz, 1.0);
     return out;
 }
 )";
@@ -6,43 +6,64 @@ namespace flint
     inline constexpr const char *WGSL_vertexShaderSource = R"(
 struct Uniforms {
     viewProjectionMatrix: mat4x4<f32>,
+    // x: sky brightness for the time of day.
+    sky: vec4<f32>,
+};
+
+struct DrawUniforms {
+    origin: vec4<f32>,
 };
 
 @group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var<uniform> draw: DrawUniforms;
 
 struct VertexInput {
     @location(0) position: vec3<f32>,
     @location(1) color: vec3<f32>,
     @location(2) uv: vec2<f32>,
-    @location(3) sky_light: f32,
+    @location(3) light_cell: u32,
+    @location(4) texture_layer: u32,
 };
 
 struct VertexOutput {
     @builtin(position) position: vec4<f32>,
     @location(0) color: vec3<f32>,
     @location(1) uv: vec2<f32>,
-    @location(2) sky_light: f32,
+    @location(2) @interpolate(flat) light_cell: u32,
+    @location(3) @interpolate(flat) texture_layer: u32,
 };
 
 @vertex
 fn vs_main(in: VertexInput) -> VertexOutput {
     var out: VertexOutput;
-    out.position = uniforms.viewProjectionMatrix * vec4<f32>(in.position, 1.0);
+    out.position = uniforms.viewProjectionMatrix * vec4<f32>(in.position + draw.origin.xyz, 1.0);
     out.color = in.color;
     out.uv = in.uv;
-    out.sky_light = in.sky_light;
+    out.light_cell = in.light_cell;
+    out.texture_layer = in.texture_layer;
     return out;
 }
 )";
 
     inline constexpr const char *WGSL_fragmentShaderSource = R"(
-@group(0) @binding(1) var t_atlas: texture_2d<f32>;
-@group(0) @binding(2) var s_atlas: sampler;
+struct Uniforms {
+    viewProjectionMatrix: mat4x4<f32>,
+    sky: vec4<f32>,
+};
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+
+@group(1) @binding(0) var t_blocks: texture_2d_array<f32>;
+@group(1) @binding(1) var s_blocks: sampler;
+
+// Light of the drawn chunk, sky | block << 4 per texel: one texel per mesh cell plus a border from the neighbours.
+@group(2) @binding(0) var t_light: texture_3d<u32>;
 
 struct FragmentInput {
     @location(0) color: vec3<f32>,
     @location(1) uv: vec2<f32>,
-    @location(2) sky_light: f32,
+    @location(2) @interpolate(flat) light_cell: u32,
+    @location(3) @interpolate(flat) texture_layer: u32,
 };
 
 // A sentinel color to indicate that the texture should be tinted.
@@ -52,7 +73,7 @@ const TINT_SENTINEL = vec3<f32>(0.1, 0.9, 0.1);
 
 @fragment
 fn fs_main(in: FragmentInput) -> @location(0) vec4<f32> {
-    let texture_color = textureSample(t_atlas, s_atlas, in.uv);
+    let texture_color = textureSample(t_blocks, s_blocks, in.uv, in.texture_layer);
 
     // Alpha test for transparent textures (e.g., leaves).
     // If the alpha value is below a threshold, discard the fragment.
@@ -60,10 +81,18 @@ fn fs_main(in: FragmentInput) -> @location(0) vec4<f32> {
         discard;
     }
 
+    // Faces are lit by the cell they look into, which the mesher packed as x | y << 8 | z << 16.
+    let light_cell = vec3<u32>(in.light_cell & 0xffu, (in.light_cell >> 8u) & 0xffu, in.light_cell >> 16u);
+    // Each texel is sky light | block light << 4. Sky light is baked for full daylight
+    // and dimmed here, so the day passing needs no remesh; block light stays as it is.
+    let packed_light = textureLoad(t_light, light_cell, 0).r;
+    let sky_light = f32(packed_light & 0xfu) / 15.0 * uniforms.sky.x;
+    let block_light = f32(packed_light >> 4u) / 15.0;
+
+    const AMBIENT_LIGHT = 0.2;
+    let light_factor = AMBIENT_LIGHT + max(sky_light, block_light) * (1.0 - AMBIENT_LIGHT);
     // If the vertex color is the sentinel value, tint the texture.
     // Otherwise, use the texture color directly.
-    const AMBIENT_LIGHT = 0.2;
-    let light_factor = AMBIENT_LIGHT + (in.sky_light / 15.0) * (1.0 - AMBIENT_LIGHT);
     if (all(in.color == TINT_SENTINEL)) {
         // We assume the texture is grayscale, so we can just use one channel (e.g., R)
         // and multiply it by the desired tint color.
@@ -32,6 +32,7 @@ void UIManager::render(
     bool showInventory,
     const player::Player &player,
     const World &world,
+    const graphics::FrameStats &frameStats,
     int windowWidth,
     int windowHeight
 )
@@ -54,7 +55,7 @@ void UIManager::render(
     // Render all active UI elements
     if (showDebugScreen)
     {
-        m_debugScreenRenderer.render_ui(player, world);
+        m_debugScreenRenderer.render_ui(player, world, frameStats);
     }
 
     if (showInventory)
@@ -3,6 +3,7 @@
 #include <SDL3/SDL.h>
 #include <webgpu/webgpu.h>
 #include "../graphics/debug_screen_renderer.h"
+#include "../graphics/frame_stats.h"
 #include "../graphics/inventory_ui_renderer.h"
 #include "../player.h"
 #include "../world.h"
@@ -27,6 +28,7 @@ namespace flint::ui
             bool showInventory,
             const player::Player &player,
             const World &world,
+            const graphics::FrameStats &frameStats,
             int windowWidth,
             int windowHeight
         );
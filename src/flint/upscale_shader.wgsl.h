@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string_view>
+
+namespace flint
+{
+    constexpr std::string_view UPSCALE_WGSL_vertexShaderSource = R"(struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+};
+
+// A single triangle that covers the whole target; uv (0, 0) is the top-left corner.
+@vertex
+fn vs_main(@builtin(vertex_index) index: u32) -> VertexOutput {
+    let uv = vec2<f32>(f32((index << 1u) & 2u), f32(index & 2u));
+    var out: VertexOutput;
+    out.position = vec4<f32>(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, 0.0, 1.0);
+    out.uv = uv;
+    return out;
+})";
+
+    constexpr std::string_view UPSCALE_WGSL_fragmentShaderSource = R"(struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+};
+
+@group(0) @binding(0)
+var t_source: texture_2d<f32>;
+@group(0) @binding(1)
+var s_source: sampler;
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    return textureSample(t_source, s_source, in.uv);
+})";
+
+} // namespace flint
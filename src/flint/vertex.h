@@ -3,6 +3,7 @@
 #include <webgpu/webgpu.h>
 #include <glm/glm.hpp>
 #include <cstddef> // Required for the offsetof macro
+#include <cstdint>
 
 namespace flint
 {
@@ -13,8 +14,11 @@ namespace flint
     {
         glm::vec3 position;
         glm::vec3 color;
-        glm::vec2 uv; // New UV coordinates
-        float sky_light;
+        glm::vec2 uv; // Coordinates within the block texture, repeating past 1.0
+        // Texel of the chunk's light texture this face looks into, packed as
+        // x | y << 8 | z << 16. Light itself is not stored in the mesh.
+        uint32_t light_cell = 0;
+        uint32_t texture_layer = 0; // Layer of the block texture array
 
         static inline WGPUVertexBufferLayout getLayout()
         {
@@ -40,12 +44,19 @@ namespace flint
                     .offset = offsetof(Vertex, uv),
                     .shaderLocation = 2,
                 },
-                // Attribute 3: Sky Light
+                // Attribute 3: Light Cell
                 {
                     .nextInChain = nullptr,
-                    .format = WGPUVertexFormat_Float32,
-                    .offset = offsetof(Vertex, sky_light),
+                    .format = WGPUVertexFormat_Uint32,
+                    .offset = offsetof(Vertex, light_cell),
                     .shaderLocation = 3,
+                },
+                // Attribute 4: Texture Layer
+                {
+                    .nextInChain = nullptr,
+                    .format = WGPUVertexFormat_Uint32,
+                    .offset = offsetof(Vertex, texture_layer),
+                    .shaderLocation = 4,
                 }
             };
 
@@ -1,65 +1,313 @@
 #include "world.h"
 #include "light.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include <utility>
+
 namespace flint
 {
+    namespace
+    {
+        // Exchanging light for a chunk only touches the chunk and its 8 neighbours,
+        // as light reaches 15 blocks, less than a chunk width. Chunks whose
+        // coordinates agree modulo 3 are at least 3 apart, so their neighbourhoods
+        // never overlap: each of the 3x3 phases can exchange all of its chunks at once.
+        constexpr int EXCHANGE_PHASE_STRIDE = 3;
+
+        int exchange_phase(const glm::ivec2 &chunkPos)
+        {
+            int px = chunkPos.x - World::floor_div(chunkPos.x, EXCHANGE_PHASE_STRIDE) * EXCHANGE_PHASE_STRIDE;
+            int pz = chunkPos.y - World::floor_div(chunkPos.y, EXCHANGE_PHASE_STRIDE) * EXCHANGE_PHASE_STRIDE;
+            return px * EXCHANGE_PHASE_STRIDE + pz;
+        }
+
+        // Runs `job(i)` for every i in [0, count), spread over the hardware threads.
+        template <typename Job>
+        void parallel_for(size_t count, const Job &job)
+        {
+            const size_t workerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(count, 1));
+
+            auto work = [&](size_t worker)
+            {
+                for (size_t i = worker; i < count; i += workerCount)
+                {
+                    job(i);
+                }
+            };
+
+            std::vector<std::future<void>> workers;
+            for (size_t worker = 1; worker < workerCount; ++worker)
+            {
+                workers.push_back(std::async(std::launch::async, work, worker));
+            }
+            work(0);
+            for (auto &worker : workers)
+            {
+                worker.get();
+            }
+        }
+    } // namespace
+
+    World::World() = default;
+
+    std::vector<glm::ivec2> World::load_chunks_around(const glm::ivec2 &center, int radius)
+    {
+        // Border light handed to the new chunks has to be settled first.
+        update_light();
+
+        std::vector<glm::ivec2> loaded;
+
+        for (int dz = -radius; dz <= radius; ++dz)
+        {
+            for (int dx = -radius; dx <= radius; ++dx)
+            {
+                glm::ivec2 pos = center + glm::ivec2(dx, dz);
+                if (!m_chunks.count(pos))
+                {
+                    loaded.push_back(pos);
+                }
+            }
+        }
+
+        // Chunks are generated and lit independently of each other, so the work is
+        // spread over worker threads and the results are inserted afterwards.
+        std::vector<std::unique_ptr<Chunk>> generated(loaded.size());
+        parallel_for(loaded.size(), [&](size_t i)
+                     {
+                         auto chunk = std::make_unique<Chunk>(loaded[i].x, loaded[i].y);
+                         chunk->generateTerrain();
+                         // Block light first: the sky pass queues the lit border blocks of both channels.
+                         Light::calculate_block_light(chunk.get());
+                         Light::calculate_sky_light(chunk.get());
+                         generated[i] = std::move(chunk);
+                     });
+
+        for (size_t i = 0; i < loaded.size(); ++i)
+        {
+            m_chunks.emplace(loaded[i], std::move(generated[i]));
+        }
+
+        // Now that the neighbours are in place, let light cross the new borders.
+        exchange_border_light(loaded);
+
+        // Chunks that were already loaded may get brighter near the new ones.
+        std::unordered_set<glm::ivec2> newlyLoaded(loaded.begin(), loaded.end());
+        for (const glm::ivec2 &pos : loaded)
+        {
+            for (int dz = -1; dz <= 1; ++dz)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    glm::ivec2 neighbor = pos + glm::ivec2(dx, dz);
+                    if (m_chunks.count(neighbor) && !newlyLoaded.count(neighbor))
+                    {
+                        glm::ivec3 chunkMin(neighbor.x * static_cast<int>(CHUNK_WIDTH), 0, neighbor.y * static_cast<int>(CHUNK_DEPTH));
+                        glm::ivec3 chunkMax = chunkMin + glm::ivec3(CHUNK_WIDTH - 1, CHUNK_HEIGHT - 1, CHUNK_DEPTH - 1);
+                        include_light_dirty(m_lightDirtyChunks, neighbor, {chunkMin, chunkMax});
+                    }
+                }
+            }
+        }
+
+        return loaded;
+    }
+
+    void World::unload_chunks_beyond(const glm::ivec2 &center, int radius)
+    {
+        // Changes inside the chunks going away still have to light their neighbours.
+        update_light();
+
+        std::vector<glm::ivec2> unloaded;
+        for (const auto &[pos, chunk] : m_chunks)
+        {
+            glm::ivec2 offset = pos - center;
+            if (std::max(std::abs(offset.x), std::abs(offset.y)) > radius)
+            {
+                unloaded.push_back(pos);
+            }
+        }
+        if (unloaded.empty())
+        {
+            return;
+        }
+
+        for (const glm::ivec2 &pos : unloaded)
+        {
+            m_chunks.erase(pos);
+            m_dirtyChunks.erase(pos);
+            m_lightDirtyChunks.erase(pos);
+        }
+
+        // Same side order as ChunkSide.
+        const std::array<glm::ivec2, CHUNK_SIDE_COUNT> sideOffsets = {
+            glm::ivec2(-1, 0), glm::ivec2(1, 0), glm::ivec2(0, -1), glm::ivec2(0, 1)};
+        for (const glm::ivec2 &pos : unloaded)
+        {
+            for (int side = 0; side < CHUNK_SIDE_COUNT; ++side)
+            {
+                // The neighbour faces the unloaded chunk on its opposite side.
+                if (Chunk *neighbor = getChunk(pos.x + sideOffsets[side].x, pos.y + sideOffsets[side].y))
+                {
+                    Light::requeue_border_light(neighbor, side ^ 1);
+                }
+            }
+        }
+    }
+
+    void World::relight()
+    {
+        // Whatever the pending changes would have done is part of the new light.
+        m_pendingBlockChanges.clear();
+        m_pendingBlockChangePositions.clear();
+
+        std::vector<glm::ivec2> positions;
+        positions.reserve(m_chunks.size());
+        for (const auto &[pos, chunk] : m_chunks)
+        {
+            positions.push_back(pos);
+        }
+
+        parallel_for(positions.size(), [&](size_t i)
+                     {
+                         Chunk *chunk = m_chunks.at(positions[i]).get();
+                         // Border light still waiting for an unloaded neighbour is queued again below.
+                         for (int side = 0; side < CHUNK_SIDE_COUNT; ++side)
+                         {
+                             chunk->take_border_light(side);
+                         }
+                         Light::calculate_block_light(chunk);
+                         Light::calculate_sky_light(chunk);
+                     });
+        exchange_border_light(positions);
 
-    World::World()
+        for (const glm::ivec2 &pos : positions)
+        {
+            glm::ivec3 chunkMin(pos.x * static_cast<int>(CHUNK_WIDTH), 0, pos.y * static_cast<int>(CHUNK_DEPTH));
+            glm::ivec3 chunkMax = chunkMin + glm::ivec3(CHUNK_WIDTH - 1, CHUNK_HEIGHT - 1, CHUNK_DEPTH - 1);
+            include_light_dirty(m_lightDirtyChunks, pos, {chunkMin, chunkMax});
+        }
+    }
+
+    void World::exchange_border_light(const std::vector<glm::ivec2> &chunks)
+    {
+        // One phase of non-overlapping neighbourhoods at a time. Light only ever
+        // grows during the exchange, so the phase order does not change the result.
+        std::array<std::vector<glm::ivec2>, EXCHANGE_PHASE_STRIDE * EXCHANGE_PHASE_STRIDE> phases;
+        for (const glm::ivec2 &pos : chunks)
+        {
+            phases[exchange_phase(pos)].push_back(pos);
+        }
+        for (const std::vector<glm::ivec2> &phase : phases)
+        {
+            parallel_for(phase.size(), [&](size_t i)
+                         { Light::exchange_border_light(this, phase[i]); });
+        }
+    }
+
+    Chunk *World::getChunk(int chunk_x, int chunk_z)
+    {
+        auto it = m_chunks.find(glm::ivec2(chunk_x, chunk_z));
+        return it != m_chunks.end() ? it->second.get() : nullptr;
+    }
+
+    const Chunk *World::getChunk(int chunk_x, int chunk_z) const
     {
-        m_chunk.generateTerrain();
-        Light::calculate_sky_light(this);
+        auto it = m_chunks.find(glm::ivec2(chunk_x, chunk_z));
+        return it != m_chunks.end() ? it->second.get() : nullptr;
     }
 
-    Chunk *World::getChunk()
+    int World::floor_div(int value, int divisor)
     {
-        return &m_chunk;
+        int quotient = value / divisor;
+        if ((value % divisor != 0) && ((value < 0) != (divisor < 0)))
+        {
+            --quotient;
+        }
+        return quotient;
     }
 
-    const Chunk *World::getChunk() const
+    glm::ivec2 World::chunk_coords_for(int x, int z)
     {
-        return &m_chunk;
+        return {floor_div(x, static_cast<int>(CHUNK_WIDTH)), floor_div(z, static_cast<int>(CHUNK_DEPTH))};
     }
 
     Block *World::getBlock(int x, int y, int z)
     {
-        return m_chunk.getBlock(x, y, z);
+        glm::ivec2 chunk_pos = chunk_coords_for(x, z);
+        Chunk *chunk = getChunk(chunk_pos.x, chunk_pos.y);
+        if (!chunk)
+        {
+            return nullptr;
+        }
+        return chunk->getBlock(x - chunk_pos.x * static_cast<int>(CHUNK_WIDTH), y, z - chunk_pos.y * static_cast<int>(CHUNK_DEPTH));
     }
 
     const Block *World::getBlock(int x, int y, int z) const
     {
-        return m_chunk.getBlock(x, y, z);
+        glm::ivec2 chunk_pos = chunk_coords_for(x, z);
+        const Chunk *chunk = getChunk(chunk_pos.x, chunk_pos.y);
+        if (!chunk)
+        {
+            return nullptr;
+        }
+        return chunk->getBlock(x - chunk_pos.x * static_cast<int>(CHUNK_WIDTH), y, z - chunk_pos.y * static_cast<int>(CHUNK_DEPTH));
+    }
+
+    uint8_t World::sky_light(int x, int y, int z) const
+    {
+        glm::ivec2 chunk_pos = chunk_coords_for(x, z);
+        const Chunk *chunk = getChunk(chunk_pos.x, chunk_pos.y);
+        const Block *block = chunk ? chunk->getBlock(x - chunk_pos.x * static_cast<int>(CHUNK_WIDTH), y, z - chunk_pos.y * static_cast<int>(CHUNK_DEPTH)) : nullptr;
+        return block ? chunk->sky_light(static_cast<size_t>(block - chunk->blocks())) : 0;
+    }
+
+    uint8_t World::block_light(int x, int y, int z) const
+    {
+        glm::ivec2 chunk_pos = chunk_coords_for(x, z);
+        const Chunk *chunk = getChunk(chunk_pos.x, chunk_pos.y);
+        const Block *block = chunk ? chunk->getBlock(x - chunk_pos.x * static_cast<int>(CHUNK_WIDTH), y, z - chunk_pos.y * static_cast<int>(CHUNK_DEPTH)) : nullptr;
+        return block ? chunk->block_light(static_cast<size_t>(block - chunk->blocks())) : 0;
     }
 
     bool World::setBlock(int x, int y, int z, BlockType type)
     {
-        Block *old_block = getBlock(x, y, z);
+        glm::ivec2 chunk_pos = chunk_coords_for(x, z);
+        Chunk *chunk = getChunk(chunk_pos.x, chunk_pos.y);
+        Block *old_block = chunk ? chunk->getBlock(x - chunk_pos.x * static_cast<int>(CHUNK_WIDTH), y, z - chunk_pos.y * static_cast<int>(CHUNK_DEPTH)) : nullptr;
         if (!old_block)
         {
             return false;
         }
 
-        bool old_transparent = old_block->isTransparent();
-        uint8_t old_light_level = old_block->sky_light;
-
-        bool success = m_chunk.setBlock(x, y, z, type);
-        if (!success)
+        glm::ivec3 position(x, y, z);
+        if (m_pendingBlockChangePositions.insert(position).second)
         {
-            return false;
+            size_t index = static_cast<size_t>(old_block - chunk->blocks());
+            m_pendingBlockChanges.push_back({position, old_block->isTransparent(), chunk->sky_light(index), chunk->block_light(index), old_block->emission()});
         }
 
-        Block *new_block = getBlock(x, y, z);
-        bool new_transparent = new_block->isTransparent();
+        // The light values stay as they were until update_light resolves the change.
+        old_block->type = type;
 
-        if (old_transparent && !new_transparent)
-        {
-            Light::propagate_light_removal(this, x, y, z, old_light_level);
-        }
-        else if (!old_transparent && new_transparent)
+        mark_dirty_around(x, z);
+
+        return true;
+    }
+
+    void World::update_light()
+    {
+        if (m_pendingBlockChanges.empty())
         {
-            Light::propagate_light_addition(this, x, y, z);
+            return;
         }
 
-        return true;
+        Light::apply_block_changes(this, m_pendingBlockChanges, m_lightDirtyChunks);
+        m_pendingBlockChanges.clear();
+        m_pendingBlockChangePositions.clear();
     }
 
     bool World::is_solid(int x, int y, int z) const
@@ -68,4 +316,42 @@ namespace flint
         return block && block->isSolid();
     }
 
-} // namespace flint
\ No newline at end of file
+    std::vector<glm::ivec2> World::take_dirty_chunks()
+    {
+        std::vector<glm::ivec2> dirty(m_dirtyChunks.begin(), m_dirtyChunks.end());
+        m_dirtyChunks.clear();
+        return dirty;
+    }
+
+    LightDirtyRegions World::take_light_dirty_chunks()
+    {
+        return std::exchange(m_lightDirtyChunks, {});
+    }
+
+    void World::mark_dirty_around(int x, int z)
+    {
+        glm::ivec2 center = chunk_coords_for(x, z);
+
+        // Geometry only changes in the edited chunk, and in a neighbour whose
+        // border faces the edited block hides or uncovers.
+        const int local_x = x - center.x * static_cast<int>(CHUNK_WIDTH);
+        const int local_z = z - center.y * static_cast<int>(CHUNK_DEPTH);
+        m_dirtyChunks.insert(center);
+        auto mark_neighbor = [this](const glm::ivec2 &pos)
+        {
+            if (m_chunks.count(pos))
+            {
+                m_dirtyChunks.insert(pos);
+            }
+        };
+        if (local_x == 0)
+            mark_neighbor(center + glm::ivec2(-1, 0));
+        if (local_x == static_cast<int>(CHUNK_WIDTH) - 1)
+            mark_neighbor(center + glm::ivec2(1, 0));
+        if (local_z == 0)
+            mark_neighbor(center + glm::ivec2(0, -1));
+        if (local_z == static_cast<int>(CHUNK_DEPTH) - 1)
+            mark_neighbor(center + glm::ivec2(0, 1));
+    }
+
+} // namespace flint
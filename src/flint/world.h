@@ -1,28 +1,120 @@
 #pragma once
 
 #include "chunk.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
 
 namespace flint
 {
 
+    // A block whose light still has to catch up with an edit: where it is, and
+    // what it was before the first edit since the light was last updated.
+    struct BlockChange
+    {
+        glm::ivec3 position;
+        bool was_transparent;
+        uint8_t sky_light;
+        uint8_t block_light;
+        uint8_t emission;
+    };
+
+    // Where light changed: per chunk, the box around its blocks whose sky or
+    // block light is different now.
+    using LightDirtyRegions = std::unordered_map<glm::ivec2, BlockBox>;
+
+    // Grows the chunk's box in `regions` to take in `box`.
+    inline void include_light_dirty(LightDirtyRegions &regions, const glm::ivec2 &chunkPos, const BlockBox &box)
+    {
+        auto [it, inserted] = regions.try_emplace(chunkPos, box);
+        if (!inserted)
+        {
+            it->second.include(box);
+        }
+    }
+
     class World
     {
     public:
         World();
 
-        Chunk *getChunk();
-        const Chunk *getChunk() const;
+        // Generates and lights every chunk within `radius` chunks (Chebyshev
+        // distance) of `center`, including light crossing over from and into
+        // the loaded neighbours. Already loaded chunks only change where that
+        // light reaches them; they are reported by `take_light_dirty_chunks`.
+        // Returns the coordinates of the chunks that were newly loaded.
+        std::vector<glm::ivec2> load_chunks_around(const glm::ivec2 &center, int radius);
+
+        // Unloads every chunk further than `radius` chunks (Chebyshev distance)
+        // from `center`, with its pending changes, border light and dirty
+        // entries. Its loaded neighbours queue their lit borders facing it again,
+        // so light crosses over when it is loaded back. Edits to an unloaded
+        // chunk are not kept; it is generated afresh.
+        void unload_chunks_beyond(const glm::ivec2 &center, int radius);
 
+        // Chunk lookup by chunk coordinates. Returns nullptr if the chunk is not loaded.
+        Chunk *getChunk(int chunk_x, int chunk_z);
+        const Chunk *getChunk(int chunk_x, int chunk_z) const;
+
+        // Block access in world coordinates.
         Block *getBlock(int x, int y, int z);
         const Block *getBlock(int x, int y, int z) const;
 
+        // Light in world coordinates, 0 where no chunk is loaded.
+        uint8_t sky_light(int x, int y, int z) const;
+        uint8_t block_light(int x, int y, int z) const;
+
+        // Changes the block right away. Its light is only brought up to date by
+        // the next `update_light`, so bulk edits are relit together.
         bool setBlock(int x, int y, int z, BlockType type);
 
+        // Resolves the light of every block changed since the last call in one
+        // combined pass (Light::apply_block_changes). Call once per tick, before
+        // meshing the dirty chunks.
+        void update_light();
+
+        // Throws the light of every loaded chunk away and lights them all again
+        // from their blocks, the way loading does, dropping any pending changes.
+        // Far slower than update_light; the light check tool compares the two.
+        void relight();
+
         bool is_solid(int x, int y, int z) const;
 
+        // Returns the chunks whose meshes changed since the last call: the edited
+        // chunk, plus a neighbour when the edit sits on their shared border.
+        std::vector<glm::ivec2> take_dirty_chunks();
+
+        // Returns where light changed since the last call, as reported by the
+        // light engine: per chunk, the box around the blocks whose light differs.
+        // Chunks next to a newly loaded one are reported whole. Light reaches
+        // further than geometry; chunks that are not also dirty only need their
+        // light re-uploaded.
+        LightDirtyRegions take_light_dirty_chunks();
+
+        // Converts a world block column to the coordinates of the chunk containing it.
+        static glm::ivec2 chunk_coords_for(int x, int z);
+
+        // Integer division rounding towards negative infinity, so that world
+        // coordinate -1 maps to chunk -1 rather than chunk 0.
+        static int floor_div(int value, int divisor);
+
     private:
-        Chunk m_chunk;
+        void mark_dirty_around(int x, int z);
+        // Lets light cross the borders of `chunks` with their loaded neighbours.
+        void exchange_border_light(const std::vector<glm::ivec2> &chunks);
+
+        std::unordered_map<glm::ivec2, std::unique_ptr<Chunk>> m_chunks;
+        std::unordered_set<glm::ivec2> m_dirtyChunks;
+        LightDirtyRegions m_lightDirtyChunks;
+
+        // Changes waiting for `update_light`, one per block: a block edited again
+        // keeps the state from before its first edit.
+        std::vector<BlockChange> m_pendingBlockChanges;
+        std::unordered_set<glm::ivec3> m_pendingBlockChangePositions;
     };
 
-} // namespace flint
\ No newline at end of file
+} // namespace flint
@@ -1,11 +1,30 @@
 #include <iostream>
+#include <string>
 
 #include "flint/app.h"
+#include "flint/benchmark.h"
+#include "flint/light_benchmark.h"
 
-int main()
+int main(int argc, char **argv)
 {
     try
     {
+        // `--benchmark` renders headlessly along a scripted camera path instead of opening a window.
+        if (argc > 1 && std::string(argv[1]) == "--benchmark")
+        {
+            flint::Benchmark benchmark(flint::BenchmarkOptions::from_args(argc, argv));
+            benchmark.run();
+            return 0;
+        }
+
+        // `--light-benchmark` times the light engine on the CPU, with no window or GPU.
+        if (argc > 1 && std::string(argv[1]) == "--light-benchmark")
+        {
+            flint::LightBenchmark benchmark(flint::LightBenchmarkOptions::from_args(argc, argv));
+            benchmark.run();
+            return 0;
+        }
+
         flint::App app;
         app.run();
     }
@@ -0,0 +1,174 @@
+// Build-time texture baker.
+//
+// Decodes a horizontal strip of square tiles (the block atlas), splits it into
+// one layer per tile, generates the full mip chain of every layer and writes
+// the texels as a C++ header in GPU upload order: mip level 0 of all layers,
+// then level 1 of all layers, and so on. Each level is tightly packed
+// (4 * size bytes per row), exactly the layout `wgpuQueueWriteTexture`
+// expects for a texture_2d_array level, so startup uploads it as-is.
+//
+// Usage: bake_textures <input.png> <output.hpp> <variable_prefix>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    float srgb_to_linear(uint8_t value)
+    {
+        float c = value / 255.0f;
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t linear_to_srgb(float value)
+    {
+        float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+    }
+
+    // Halves a square RGBA8 sRGB image with a 2x2 box filter. Color is averaged in
+    // linear space, weighted by alpha so transparent texels (e.g. around leaves)
+    // don't darken their neighbours.
+    std::vector<uint8_t> downsample_rgba(const std::vector<uint8_t> &src, uint32_t size)
+    {
+        static const std::array<float, 256> toLinear = []
+        {
+            std::array<float, 256> table{};
+            for (int i = 0; i < 256; ++i)
+            {
+                table[i] = srgb_to_linear(static_cast<uint8_t>(i));
+            }
+            return table;
+        }();
+
+        uint32_t half = size / 2;
+        std::vector<uint8_t> dst(static_cast<size_t>(half) * half * 4);
+        for (uint32_t y = 0; y < half; ++y)
+        {
+            for (uint32_t x = 0; x < half; ++x)
+            {
+                float rgb[3] = {0.0f, 0.0f, 0.0f};
+                float alpha = 0.0f;
+                for (uint32_t dy = 0; dy < 2; ++dy)
+                {
+                    for (uint32_t dx = 0; dx < 2; ++dx)
+                    {
+                        const uint8_t *texel = &src[((2 * y + dy) * size + (2 * x + dx)) * 4];
+                        float a = texel[3] / 255.0f;
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            rgb[c] += toLinear[texel[c]] * a;
+                        }
+                        alpha += a;
+                    }
+                }
+
+                uint8_t *out = &dst[(y * half + x) * 4];
+                for (int c = 0; c < 3; ++c)
+                {
+                    out[c] = alpha > 0.0f ? linear_to_srgb(rgb[c] / alpha) : 0;
+                }
+                out[3] = static_cast<uint8_t>(std::lround(alpha / 4.0f * 255.0f));
+            }
+        }
+        return dst;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: bake_textures <input.png> <output.hpp> <variable_prefix>" << std::endl;
+        return 1;
+    }
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+    const std::string prefix = argv[3];
+
+    int width, height, channels;
+    stbi_uc *pixels = stbi_load(inputPath.c_str(), &width, &height, &channels, 4); // Force 4 channels (RGBA)
+    if (!pixels)
+    {
+        std::cerr << "Failed to load " << inputPath << std::endl;
+        return 1;
+    }
+
+    // Tiles are square, so the strip's height is the tile size.
+    const uint32_t tileSize = static_cast<uint32_t>(height);
+    if (tileSize == 0 || width % height != 0 || (tileSize & (tileSize - 1)) != 0)
+    {
+        std::cerr << inputPath << " must be a row of square power-of-two tiles" << std::endl;
+        stbi_image_free(pixels);
+        return 1;
+    }
+    const uint32_t layerCount = static_cast<uint32_t>(width) / tileSize;
+    const uint32_t mipLevelCount = static_cast<uint32_t>(std::log2(tileSize)) + 1;
+
+    // Split the strip into one tightly packed image per layer.
+    std::vector<std::vector<uint8_t>> layers(layerCount);
+    for (uint32_t layer = 0; layer < layerCount; ++layer)
+    {
+        layers[layer].resize(static_cast<size_t>(tileSize) * tileSize * 4);
+        for (uint32_t row = 0; row < tileSize; ++row)
+        {
+            const stbi_uc *src = pixels + (static_cast<size_t>(row) * width + layer * tileSize) * 4;
+            std::memcpy(&layers[layer][static_cast<size_t>(row) * tileSize * 4], src, tileSize * 4);
+        }
+    }
+    stbi_image_free(pixels);
+
+    // Lay every level out in upload order: all layers of level 0, then level 1, ...
+    std::vector<uint8_t> texels;
+    uint32_t levelSize = tileSize;
+    for (uint32_t level = 0; level < mipLevelCount; ++level)
+    {
+        for (const auto &layer : layers)
+        {
+            texels.insert(texels.end(), layer.begin(), layer.end());
+        }
+        if (levelSize > 1)
+        {
+            for (auto &layer : layers)
+            {
+                layer = downsample_rgba(layer, levelSize);
+            }
+            levelSize /= 2;
+        }
+    }
+
+    std::ofstream out(outputPath);
+    if (!out)
+    {
+        std::cerr << "Failed to open " << outputPath << std::endl;
+        return 1;
+    }
+
+    out << "/* This file is auto-generated by bake_textures. DO NOT EDIT. */\n\n";
+    out << "#pragma once\n\n";
+    out << "#include <cstdint>\n\n";
+    out << "static const uint32_t " << prefix << "_tile_size = " << tileSize << ";\n";
+    out << "static const uint32_t " << prefix << "_layer_count = " << layerCount << ";\n";
+    out << "static const uint32_t " << prefix << "_mip_level_count = " << mipLevelCount << ";\n";
+    out << "// RGBA8 sRGB texels in upload order: for each mip level, all layers back to back.\n";
+    out << "static const unsigned char " << prefix << "_texels[] = {";
+    for (size_t i = 0; i < texels.size(); ++i)
+    {
+        out << (i % 16 == 0 ? "\n    " : " ") << static_cast<unsigned>(texels[i]) << ",";
+    }
+    out << "\n};\n";
+
+    std::cout << "Baked " << inputPath << " -> " << outputPath << " (" << layerCount << " layers, "
+              << mipLevelCount << " mips, " << texels.size() << " bytes)" << std::endl;
+    return 0;
+}
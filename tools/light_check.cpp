@@ -0,0 +1,272 @@
+// Differential test and timing harness for the light engine.
+//
+// Builds small worlds from fixtures, then makes random block edits in them.
+// After every step the incrementally updated light (World::update_light) is
+// compared, block by block and in both channels, against a second world with
+// the same blocks lit from scratch (World::relight, i.e. calculate_block_light
+// and calculate_sky_light per chunk plus the border exchange). Both paths are
+// timed. Needs no window or GPU, so it can run anywhere the engine compiles.
+//
+// Usage: light_check [--fixture NAME|all] [--steps N] [--seed N] [--batch N]
+//
+// Exits with 1 at the first block whose light differs, printing the fixture,
+// seed and step that reproduce it.
+
+#include "flint/benchmark_utils.h"
+#include "flint/world.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace flint;
+    using bench::Clock;
+    using bench::EDIT_AREA;
+    using bench::EDIT_WORLD_RADIUS;
+    using bench::elapsed_ms;
+    using bench::mean;
+    using bench::percentile;
+    using bench::Random;
+    using bench::surface_height;
+
+    struct Options
+    {
+        std::string fixture = "all";
+        uint32_t steps = 500;
+        uint32_t seed = 1;
+        // Edits per step are 1 to this many, relit as one batch.
+        uint32_t batch = 8;
+    };
+
+    Options parse_options(int argc, char **argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--fixture" && hasValue)
+                options.fixture = argv[++i];
+            else if (arg == "--steps" && hasValue)
+                options.steps = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--seed" && hasValue)
+                options.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--batch" && hasValue)
+                options.batch = std::max<uint32_t>(static_cast<uint32_t>(std::stoul(argv[++i])), 1);
+            else
+                throw std::runtime_error("Unknown argument: " + arg);
+        }
+        return options;
+    }
+
+    // A world to start from: the chunks around `center`, changed by `build`
+    // with setBlock so both worlds can be given the same blocks.
+    struct Fixture
+    {
+        const char *name;
+        glm::ivec2 center;
+        void (*build)(World &world, const glm::ivec3 &origin);
+    };
+
+    void fill_box(World &world, const glm::ivec3 &min, const glm::ivec3 &max, BlockType type)
+    {
+        for (int x = min.x; x <= max.x; ++x)
+        {
+            for (int y = min.y; y <= max.y; ++y)
+            {
+                for (int z = min.z; z <= max.z; ++z)
+                {
+                    world.setBlock(x, y, z, type);
+                }
+            }
+        }
+    }
+
+    const Fixture FIXTURES[] = {
+        // The generated spawn area, with its tree and pillars.
+        {"spawn", {0, 0}, [](World &, const glm::ivec3 &) {}},
+        // Open hills, away from the flattened spawn.
+        {"hills", {4, 4}, [](World &, const glm::ivec3 &) {}},
+        // A room dug out under the spawn, lit by a light source and by a
+        // shaft up to the sky, so edits there darken and relight both channels.
+        {"cave", {0, 0}, [](World &world, const glm::ivec3 &origin)
+         {
+             const glm::ivec3 room = origin + glm::ivec3(-6, 3, -6);
+             fill_box(world, room, room + glm::ivec3(11, 5, 11), BlockType::Air);
+             for (int y = room.y + 6; y < static_cast<int>(CHUNK_HEIGHT); ++y)
+             {
+                 world.setBlock(room.x + 2, y, room.z + 2, BlockType::Air);
+             }
+             world.setBlock(room.x + 8, room.y, room.z + 8, BlockType::Glowstone);
+         }},
+        // A roof over the middle chunks with lamps underneath, where block light
+        // does most of the lighting and sky light only leaks in from the edges.
+        {"roofed", {0, 0}, [](World &world, const glm::ivec3 &origin)
+         {
+             const int roof = static_cast<int>(CHUNK_HEIGHT) - 4;
+             fill_box(world, glm::ivec3(origin.x - 20, roof, origin.z - 20), glm::ivec3(origin.x + 19, roof, origin.z + 19), BlockType::Dirt);
+             for (int x = origin.x - 17; x < origin.x + 17; x += 7)
+             {
+                 for (int z = origin.z - 17; z < origin.z + 17; z += 7)
+                 {
+                     world.setBlock(x, roof - 1, z, BlockType::Glowstone);
+                 }
+             }
+         }},
+    };
+
+    struct Timings
+    {
+        std::vector<double> incremental;
+        std::vector<double> full;
+    };
+
+    // Compares the light of every loaded block. Reports the first difference
+    // and returns false if there is one.
+    bool light_matches(const World &world, const World &reference, const glm::ivec2 &center)
+    {
+        for (int cz = center.y - EDIT_WORLD_RADIUS; cz <= center.y + EDIT_WORLD_RADIUS; ++cz)
+        {
+            for (int cx = center.x - EDIT_WORLD_RADIUS; cx <= center.x + EDIT_WORLD_RADIUS; ++cx)
+            {
+                const Chunk *chunk = world.getChunk(cx, cz);
+                const Chunk *expected = reference.getChunk(cx, cz);
+                for (size_t i = 0; i < CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH; ++i)
+                {
+                    const bool skyDiffers = chunk->sky_light(i) != expected->sky_light(i);
+                    if (!skyDiffers && chunk->block_light(i) == expected->block_light(i))
+                    {
+                        continue;
+                    }
+
+                    const int x = cx * static_cast<int>(CHUNK_WIDTH) + static_cast<int>(i / (CHUNK_HEIGHT * CHUNK_DEPTH));
+                    const int y = static_cast<int>(i / CHUNK_DEPTH % CHUNK_HEIGHT);
+                    const int z = cz * static_cast<int>(CHUNK_DEPTH) + static_cast<int>(i % CHUNK_DEPTH);
+                    std::cerr << "  " << (skyDiffers ? "sky" : "block") << " light differs at (" << x << ", " << y << ", " << z << "): "
+                              << "incremental " << int(skyDiffers ? chunk->sky_light(i) : chunk->block_light(i))
+                              << ", full " << int(skyDiffers ? expected->sky_light(i) : expected->block_light(i)) << std::endl;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Runs one fixture. Returns false at the first step whose light differs.
+    bool run_fixture(const Fixture &fixture, const Options &options, Timings &timings)
+    {
+        World world;
+        World reference;
+        world.load_chunks_around(fixture.center, EDIT_WORLD_RADIUS);
+        reference.load_chunks_around(fixture.center, EDIT_WORLD_RADIUS);
+
+        const glm::ivec3 origin(fixture.center.x * static_cast<int>(CHUNK_WIDTH), surface_height(world, fixture.center.x * static_cast<int>(CHUNK_WIDTH), fixture.center.y * static_cast<int>(CHUNK_DEPTH)), fixture.center.y * static_cast<int>(CHUNK_DEPTH));
+        fixture.build(world, origin);
+        fixture.build(reference, origin);
+        world.update_light();
+        reference.relight();
+        if (!light_matches(world, reference, fixture.center))
+        {
+            std::cerr << fixture.name << ": light differs after building the fixture" << std::endl;
+            return false;
+        }
+
+        // Edits come in small clusters around a random spot near the ground, so
+        // the changes of a batch overlap and the light has something to do.
+        static constexpr BlockType EDIT_TYPES[] = {
+            BlockType::Air, BlockType::Air, BlockType::Air, BlockType::Air,
+            BlockType::Dirt, BlockType::Dirt, BlockType::Dirt,
+            BlockType::Glowstone, BlockType::Glowstone,
+            BlockType::OakLeaves};
+
+        Random random(options.seed);
+        const int minX = (fixture.center.x - 1) * static_cast<int>(CHUNK_WIDTH);
+        const int minZ = (fixture.center.y - 1) * static_cast<int>(CHUNK_DEPTH);
+        std::vector<glm::ivec3> edits;
+        for (uint32_t step = 1; step <= options.steps; ++step)
+        {
+            const int x = minX + random.next(EDIT_AREA);
+            const int z = minZ + random.next(EDIT_AREA);
+            const int y = std::max(surface_height(world, x, z), 0) + random.next(16) - 10;
+
+            edits.clear();
+            const int count = 1 + random.next(static_cast<int>(options.batch));
+            for (int i = 0; i < count; ++i)
+            {
+                glm::ivec3 position(std::clamp(x + random.next(5) - 2, minX, minX + EDIT_AREA - 1),
+                                    std::clamp(y + random.next(5) - 2, 0, static_cast<int>(CHUNK_HEIGHT) - 1),
+                                    std::clamp(z + random.next(5) - 2, minZ, minZ + EDIT_AREA - 1));
+                BlockType type = EDIT_TYPES[random.next(static_cast<int>(std::size(EDIT_TYPES)))];
+                world.setBlock(position.x, position.y, position.z, type);
+                reference.setBlock(position.x, position.y, position.z, type);
+                edits.push_back(position);
+            }
+
+            Clock::time_point start = Clock::now();
+            world.update_light();
+            timings.incremental.push_back(elapsed_ms(start, Clock::now()));
+
+            start = Clock::now();
+            reference.relight();
+            timings.full.push_back(elapsed_ms(start, Clock::now()));
+
+            if (!light_matches(world, reference, fixture.center))
+            {
+                std::cerr << fixture.name << ": light differs after step " << step << " (--fixture " << fixture.name << " --seed " << options.seed
+                          << " --steps " << step << " --batch " << options.batch << "), edits of the step:";
+                for (const glm::ivec3 &edit : edits)
+                {
+                    std::cerr << " (" << edit.x << ", " << edit.y << ", " << edit.z << ")";
+                }
+                std::cerr << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        const Options options = parse_options(argc, argv);
+
+        bool found = false;
+        for (const Fixture &fixture : FIXTURES)
+        {
+            if (options.fixture != "all" && options.fixture != fixture.name)
+            {
+                continue;
+            }
+            found = true;
+
+            Timings timings;
+            if (!run_fixture(fixture, options, timings))
+            {
+                return 1;
+            }
+
+            std::cout << fixture.name << ": " << options.steps << " steps match" << std::endl;
+            std::cout << "  incremental: mean " << mean(timings.incremental) << " ms, p50 " << percentile(timings.incremental, 0.50) << " ms, p95 " << percentile(timings.incremental, 0.95) << " ms" << std::endl;
+            std::cout << "  full:        mean " << mean(timings.full) << " ms, p50 " << percentile(timings.full, 0.50) << " ms, p95 " << percentile(timings.full, 0.95) << " ms" << std::endl;
+        }
+
+        if (!found)
+        {
+            throw std::runtime_error("Unknown fixture: " + options.fixture);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "light_check: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}